@@ -73,6 +73,16 @@ static bool IsSuccess(const T& result)
 	return isSuccess;
 }
 
+// Abv[h̕IuWFNg쐬ꏊ
+// --> oPbg̐p̃vtBbNXɍ쐬AListObjects() ł͕\Ȃ
+
+static const std::wstring COMPOSE_COMPONENT_PREFIX{ L".wincse-compose/" };
+
+static bool isComposeComponentKey(const std::wstring& argKey)
+{
+	return argKey.compare(0, COMPOSE_COMPONENT_PREFIX.length(), COMPOSE_COMPONENT_PREFIX) == 0;
+}
+
 namespace CSEGGS {
 
 bool GcpGsClient::ListBuckets(CALLER_ARG DirEntryListType* pDirEntryList)
@@ -240,6 +250,14 @@ bool GcpGsClient::ListObjects(CALLER_ARG const ObjectKey& argObjKey, DirEntryLis
 				continue;
 			}
 
+			if (isComposeComponentKey(keyFull))
+			{
+				// Abv[h̕IuWFNg̒uꏊ
+
+				traceW(L"ignore keyFull=%s", keyFull.c_str());
+				continue;
+			}
+
 			// Prefix 菜
 			// 
 			// "dir/"           --> ""              ... LŏĂ
@@ -287,6 +305,12 @@ bool GcpGsClient::ListObjects(CALLER_ARG const ObjectKey& argObjKey, DirEntryLis
 				continue;
 			}
 
+			if (isComposeComponentKey(keyFull))
+			{
+				traceW(L"ignore keyFull=%s", keyFull.c_str());
+				continue;
+			}
+
 			// Prefix 菜
 			// 
 			// "dir/"           --> ""              ... LŏĂ
@@ -421,6 +445,15 @@ bool GcpGsClient::PutObject(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSC
 
 	traceW(L"argObjKey=%s argFileInfo=%s argInputPath=%s", argObjKey.c_str(), FileInfoToStringW(argFileInfo).c_str(), argInputPath);
 
+	// TCY𒴂t@ĆAƂɕŃAbv[hĂ猋
+
+	const auto PART_SIZE_BYTE = FILESIZE_1MiBll * mRuntimeEnv->TransferWriteSizeMib;
+
+	if (!FA_IS_DIR(argFileInfo.FileAttributes) && static_cast<FILEIO_LENGTH_T>(argFileInfo.FileSize) > PART_SIZE_BYTE)
+	{
+		return this->uploadComposite(CONT_CALLER argObjKey, argFileInfo, argInputPath);
+	}
+
 	// ^f[^ݒ
 
 	gcs::ObjectMetadata inMetadata;
@@ -477,6 +510,249 @@ bool GcpGsClient::PutObject(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSC
 	return true;
 }
 
+struct UploadComponentTask : public IOnDemandTask
+{
+	GcpGsClient* mThat;
+	const ObjectKey mObjKey;
+	const std::string mComponentName;
+	const std::filesystem::path mInputPath;
+	std::shared_ptr<UploadFilePartType> mFilePart;
+
+	UploadComponentTask(
+		GcpGsClient* argThat,
+		const ObjectKey& argObjKey,
+		const std::string& argComponentName,
+		const std::filesystem::path& argInputPath,
+		const std::shared_ptr<UploadFilePartType>& argFilePart)
+		:
+		mThat(argThat),
+		mObjKey(argObjKey),
+		mComponentName(argComponentName),
+		mInputPath(argInputPath),
+		mFilePart(argFilePart)
+	{
+	}
+
+	void run(int argThreadIndex) override
+	{
+		NEW_LOG_BLOCK();
+
+		std::optional<std::int64_t> result;
+
+		try
+		{
+			if (mFilePart->mInterrupt)
+			{
+				errorW(L"@%d Interruption request received", argThreadIndex);
+			}
+			else
+			{
+				result = mThat->uploadComponent(START_CALLER mObjKey, mComponentName, mInputPath, mFilePart);
+			}
+		}
+		catch (const std::exception& ex)
+		{
+			errorA("catch exception: what=[%s]", ex.what());
+		}
+		catch (...)
+		{
+			errorW(L"catch unknown");
+		}
+
+		// ʂݒ肵AVOiԂɕύX
+
+		mFilePart->setResult(std::move(result));
+	}
+};
+
+std::optional<std::int64_t> GcpGsClient::uploadComponent(CALLER_ARG const ObjectKey& argObjKey,
+	const std::string& argComponentName, const std::filesystem::path& argInputPath, const std::shared_ptr<UploadFilePartType>& argFilePart)
+{
+	NEW_LOG_BLOCK();
+
+	traceA("argComponentName=%s", argComponentName.c_str());
+	traceW(L"argFilePart=%s", argFilePart->str().c_str());
+
+	// ÕIuWFNg݂Ƃ͏㏑Ȃ
+
+	auto stream = mGsClient->WriteObject(argObjKey.bucketA(), argComponentName, gcs::IfGenerationMatch(0));
+
+	const auto nWrite = CSEDVC::writeStreamFromFile(CONT_CALLER &stream, argInputPath, argFilePart->mOffset, argFilePart->mLength);
+
+	if (nWrite != argFilePart->mLength)
+	{
+		errorW(L"fault: writeStreamFromFile argInputPath=%s", argInputPath.c_str());
+		return std::nullopt;
+	}
+
+	stream.Close();
+
+	const auto& outMetadata = stream.metadata();
+	if (!IsSuccess(outMetadata))
+	{
+		errorW(L"fault: WriteObject argFilePart=%s", argFilePart->str().c_str());
+		return std::nullopt;
+	}
+
+	return outMetadata->generation();
+}
+
+void GcpGsClient::deleteStaleComponents(CALLER_ARG const ObjectKey& argObjKey)
+{
+	NEW_LOG_BLOCK();
+
+	// ȑÕAbv[hfĎcIuWFNg폜
+	// --> 瓯L[ɃAbv[ĥ̂Ȃ悤ɁAÂ̂Ώۂɂ
+
+	const auto threshold = GetCurrentUtcMillis() - TIMEMILLIS_1DAYll;
+	const auto prefix{ WC2MB(COMPOSE_COMPONENT_PREFIX) + argObjKey.keyA() + "/" };
+
+	for (auto&& item: mGsClient->ListObjects(argObjKey.bucketA(), gcs::Prefix(prefix)))
+	{
+		if (!IsSuccess(item))
+		{
+			errorW(L"fault: ListObjects argObjKey=%s", argObjKey.c_str());
+			return;
+		}
+
+		if (TimePointToUtcMillis(item->time_created()) >= threshold)
+		{
+			continue;
+		}
+
+		traceA("delete stale component name=%s", item->name().c_str());
+
+		const auto status = mGsClient->DeleteObject(argObjKey.bucketA(), item->name(), gcs::Generation(item->generation()));
+		if (!IsSuccess(status))
+		{
+			errorW(L"fault: DeleteObject name=%s", MB2WC(item->name()).c_str());
+		}
+	}
+}
+
+bool GcpGsClient::uploadComposite(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
+{
+	NEW_LOG_BLOCK();
+	APP_ASSERT(argInputPath);
+
+	// xɌł镔IuWFNg̏
+	// --> Ƃ͕̃TCY傫
+
+	const FILEIO_LENGTH_T MAX_COMPOSE_SOURCES = 32;
+
+	const auto fileSize = static_cast<FILEIO_LENGTH_T>(argFileInfo.FileSize);
+	const auto partSize = max(FILESIZE_1MiBll * mRuntimeEnv->TransferWriteSizeMib, UNIT_COUNT(fileSize, MAX_COMPOSE_SOURCES));
+	const auto partCount = UNIT_COUNT(fileSize, partSize);
+
+	traceW(L"fileSize=%lld partSize=%lld partCount=%lld", fileSize, partSize, partCount);
+
+	// IuWFNg͐p̃vtBbNX̉ɈꎞIȖOō쐬Aɍ폜
+	// --> "<COMPOSE_COMPONENT_PREFIX><L[>/<Jn>-<p[gԍ>"
+
+	this->deleteStaleComponents(CONT_CALLER argObjKey);
+
+	const auto namePrefix{ WC2MB(COMPOSE_COMPONENT_PREFIX) + argObjKey.keyA() + "/" + std::to_string(GetCurrentUtcMillis()) + "-" };
+
+	std::vector<std::pair<std::string, std::shared_ptr<UploadFilePartType>>> components;
+
+	for (int i=0; i<partCount; ++i)
+	{
+		const auto partNumber = i + 1;
+		const auto partOffset = i * partSize;
+		const auto partLength = min(partSize, fileSize - partOffset);
+
+		const auto componentName{ namePrefix + std::to_string(partNumber) };
+		const auto filePart{ std::make_shared<UploadFilePartType>(partNumber, partOffset, partLength, std::nullopt) };
+
+		// Ɏs鐔͒x^XÑXbh (file_io_threads) ɂ
+
+		traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+		mDelayedWorker->addTask(new UploadComponentTask{ this, argObjKey, componentName, argInputPath, filePart });
+
+		components.emplace_back(componentName, filePart);
+	}
+
+	// ^XN̊҂
+
+	std::vector<gcs::ComposeSourceObject> sourceObjects;
+	bool errorExists = false;
+
+	for (const auto& component: components)
+	{
+		const auto result{ component.second->getResult() };
+
+		if (!result)
+		{
+			errorExists = true;
+
+			errorW(L"fault: mPartNumber=%d", component.second->mPartNumber);
+			break;
+		}
+
+		gcs::ComposeSourceObject sourceObject;
+		sourceObject.object_name = component.first;
+		sourceObject.generation = *result;
+
+		sourceObjects.push_back(std::move(sourceObject));
+	}
+
+	bool composed = false;
+
+	if (errorExists)
+	{
+		// ꕔɃG[݂̂ŁASĂ̒x^XN𒆒fĊ҂
+
+		for (auto& component: components)
+		{
+			component.second->mInterrupt = true;
+		}
+
+		for (auto& component: components)
+		{
+			component.second->getResult();
+		}
+	}
+	else
+	{
+		// ^f[^ Content-Type ݒ肵Č
+
+		gcs::ObjectMetadata inMetadata;
+		setMetadataFromFileInfo(CONT_CALLER argFileInfo, &inMetadata.mutable_metadata());
+
+		const auto contentType{ CSEDVC::getContentType(CONT_CALLER argFileInfo.FileSize, argInputPath, argObjKey.key()) };
+		inMetadata.set_content_type(WC2MB(contentType));
+
+		const auto outMetadata = mGsClient->ComposeObject(argObjKey.bucketA(), sourceObjects, argObjKey.keyA(), gcs::WithObjectMetadata(inMetadata));
+
+		if (IsSuccess(outMetadata))
+		{
+			traceA("success: metadata.name=%s metadata.size=%llu", outMetadata->name().c_str(), outMetadata->size());
+
+			composed = true;
+		}
+		else
+		{
+			errorW(L"fault: ComposeObject argObjKey=%s", argObjKey.c_str());
+		}
+	}
+
+	// IuWFNg폜
+	// --> ŝ͍쐬ĂȂƂ
+	//     폜łɎĉ́AɓL[Abv[hƂɍ폜
+
+	for (const auto& component: components)
+	{
+		const auto status = mGsClient->DeleteObject(argObjKey.bucketA(), component.first);
+		if (!IsSuccess(status) && status.code() != google::cloud::StatusCode::kNotFound)
+		{
+			errorW(L"fault: DeleteObject componentName=%s", MB2WC(component.first).c_str());
+		}
+	}
+
+	return composed;
+}
+
 bool GcpGsClient::CopyObject(CALLER_ARG const ObjectKey& argSrcObjKey, const ObjectKey& argDstObjKey)
 {
 	NEW_LOG_BLOCK();
@@ -499,17 +775,23 @@ bool GcpGsClient::CopyObject(CALLER_ARG const ObjectKey& argSrcObjKey, const Obj
 	return true;
 }
 
-FILEIO_LENGTH_T GcpGsClient::GetObjectAndWriteFile(CALLER_ARG const ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, FILEIO_LENGTH_T argOffset, FILEIO_LENGTH_T argLength)
+FILEIO_LENGTH_T GcpGsClient::GetObjectAndWriteFile(CALLER_ARG const ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, FILEIO_LENGTH_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag)
 {
 	NEW_LOG_BLOCK();
 	APP_ASSERT(argOffset >= 0LL);
 	APP_ASSERT(argLength > 0);
 
-	auto stream = mGsClient->ReadObject(argObjKey.bucketA(), argObjKey.keyA(), gcs::ReadRange(argOffset, argOffset + argLength));
+	// Ɏ擾͈͂ƓêƂ擾
+	// --> [gXVĂ 412 Ŏs
+
+	auto stream = argETag.empty()
+		? mGsClient->ReadObject(argObjKey.bucketA(), argObjKey.keyA(), gcs::ReadRange(argOffset, argOffset + argLength))
+		: mGsClient->ReadObject(argObjKey.bucketA(), argObjKey.keyA(), gcs::ReadRange(argOffset, argOffset + argLength), gcs::IfMatchEtag(WC2MB(argETag)));
+
 	if (!stream)
 	{
-		errorW(L"fault: ReadObject argObjKey=%s argOffset=%lld argLength=%lld", argObjKey.c_str(), argOffset, argLength);
-		return -1LL;
+		errorW(L"fault: ReadObject argObjKey=%s argOffset=%lld argLength=%lld argETag=%s", argObjKey.c_str(), argOffset, argLength, argETag.c_str());
+		return stream.status().code() == google::cloud::StatusCode::kFailedPrecondition ? FILEIO_LENGTH_ETAG_MISMATCH : -1LL;
 	}
 
 	// stream ̓et@Cɏo͂
@@ -517,6 +799,30 @@ FILEIO_LENGTH_T GcpGsClient::GetObjectAndWriteFile(CALLER_ARG const ObjectKey& a
 	return CSEDVC::writeFileFromStream(CONT_CALLER argOutputPath, argOffset, &stream, argLength);
 }
 
+FILEIO_LENGTH_T GcpGsClient::GetObjectAndWriteBuffer(CALLER_ARG const ObjectKey& argObjKey, PVOID argOutputBuffer, FILEIO_LENGTH_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag)
+{
+	NEW_LOG_BLOCK();
+	APP_ASSERT(argOutputBuffer);
+	APP_ASSERT(argOffset >= 0LL);
+	APP_ASSERT(argLength > 0);
+
+	// Õp[gƓł̓êƂ擾
+
+	auto stream = argETag.empty()
+		? mGsClient->ReadObject(argObjKey.bucketA(), argObjKey.keyA(), gcs::ReadRange(argOffset, argOffset + argLength))
+		: mGsClient->ReadObject(argObjKey.bucketA(), argObjKey.keyA(), gcs::ReadRange(argOffset, argOffset + argLength), gcs::IfMatchEtag(WC2MB(argETag)));
+
+	if (!stream)
+	{
+		errorW(L"fault: ReadObject argObjKey=%s argOffset=%lld argLength=%lld argETag=%s", argObjKey.c_str(), argOffset, argLength, argETag.c_str());
+		return stream.status().code() == google::cloud::StatusCode::kFailedPrecondition ? FILEIO_LENGTH_ETAG_MISMATCH : -1LL;
+	}
+
+	// stream ̓eobt@ɏo͂
+
+	return CSEDVC::writeBufferFromStream(CONT_CALLER argOutputBuffer, &stream, argLength);
+}
+
 }	// namespace CSEGGS
 
 // EOF
\ No newline at end of file
@@ -5,6 +5,10 @@
 namespace CSEGGS
 {
 
+// Abv[hIuWFNg generation
+
+using UploadFilePartType = CSELIB::FilePart<std::optional<std::int64_t>>;
+
 class GcpGsClient : public CSEDVC::IApiClient
 {
 protected:
@@ -13,6 +17,9 @@ protected:
 	const std::wstring										mProjectId;
 	const std::unique_ptr<google::cloud::storage::Client>	mGsClient;
 
+	WINCSEGCPGS_API void deleteStaleComponents(CALLER_ARG const CSELIB::ObjectKey& argObjKey);
+	WINCSEGCPGS_API bool uploadComposite(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath);
+
 public:
 	GcpGsClient(const CSEDVC::RuntimeEnv* argRuntimeEnv, CSELIB::IWorker* argDelayedWorker, const std::wstring& argProjectId)
 		:
@@ -30,6 +37,9 @@ public:
 		return true;
 	}
 
+	WINCSEGCPGS_API std::optional<std::int64_t> uploadComponent(CALLER_ARG const CSELIB::ObjectKey& argObjKey,
+		const std::string& argComponentName, const std::filesystem::path& argInputPath, const std::shared_ptr<UploadFilePartType>& argFilePart);
+
 	// SDK API Ăяo̎
 
 	WINCSEGCPGS_API bool ListBuckets(CALLER_ARG CSELIB::DirEntryListType* pDirEntryList) override;
@@ -39,7 +49,8 @@ public:
 	WINCSEGCPGS_API bool DeleteObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey) override;
 	WINCSEGCPGS_API bool PutObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath) override;
 	WINCSEGCPGS_API bool CopyObject(CALLER_ARG const CSELIB::ObjectKey& argSrcObjKey, const CSELIB::ObjectKey& argDstObjKey) override;
-	WINCSEGCPGS_API CSELIB::FILEIO_LENGTH_T GetObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) override;
+	WINCSEGCPGS_API CSELIB::FILEIO_LENGTH_T GetObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) override;
+	WINCSEGCPGS_API CSELIB::FILEIO_LENGTH_T GetObjectAndWriteBuffer(CALLER_ARG const CSELIB::ObjectKey& argObjKey, PVOID argOutputBuffer, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) override;
 };
 
 }	// namespace CSEGGS
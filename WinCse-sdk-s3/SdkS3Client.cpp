@@ -469,7 +469,7 @@ bool SdkS3Client::CopyObject(CALLER_ARG const ObjectKey& argSrcObjKey, const Obj
 }
 
 FILEIO_LENGTH_T SdkS3Client::GetObjectAndWriteFile(CALLER_ARG const ObjectKey& argObjKey,
-    const std::filesystem::path& argOutputPath, FILEIO_LENGTH_T argOffset, FILEIO_LENGTH_T argLength)
+    const std::filesystem::path& argOutputPath, FILEIO_LENGTH_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag)
 {
     NEW_LOG_BLOCK();
     APP_ASSERT(argOffset >= 0LL);
@@ -491,11 +491,19 @@ FILEIO_LENGTH_T SdkS3Client::GetObjectAndWriteFile(CALLER_ARG const ObjectKey& a
     request.SetKey(argObjKey.keyA());
     request.SetRange(range);
 
+    if (!argETag.empty())
+    {
+        // Ɏ擾͈͂ƓêƂ擾
+        // --> [gXVĂ 412 Ŏs
+
+        request.SetIfMatch(WC2MB(argETag));
+    }
+
     const auto outcome = executeWithRetry(mS3Client, &Aws::S3::S3Client::GetObject, request, mRuntimeEnv->MaxApiRetryCount);
     if (!IsSuccess(outcome))
     {
-        errorW(L"fault: GetObject argObjKey=%s", argObjKey.c_str());
-        return -1LL;
+        errorW(L"fault: GetObject argObjKey=%s argETag=%s", argObjKey.c_str(), argETag.c_str());
+        return OutcomeIsHttpCode412(outcome) ? FILEIO_LENGTH_ETAG_MISMATCH : -1LL;
     }
 
     const auto& result{ outcome.GetResult() };
@@ -514,6 +522,61 @@ FILEIO_LENGTH_T SdkS3Client::GetObjectAndWriteFile(CALLER_ARG const ObjectKey& a
     return writeFileFromStream(CONT_CALLER argOutputPath, argOffset, &body, contentLength);
 }
 
+FILEIO_LENGTH_T SdkS3Client::GetObjectAndWriteBuffer(CALLER_ARG const ObjectKey& argObjKey,
+    PVOID argOutputBuffer, FILEIO_LENGTH_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag)
+{
+    NEW_LOG_BLOCK();
+    APP_ASSERT(argOutputBuffer);
+    APP_ASSERT(argOffset >= 0LL);
+    APP_ASSERT(argLength > 0);
+
+    const auto endOffset = argOffset + argLength - 1;
+
+    std::ostringstream ss;
+    ss << "bytes=";
+    ss << argOffset;
+    ss << "-";
+    ss << endOffset;
+
+    const auto range{ ss.str() };
+    traceA("range=%s", range.c_str());
+
+    Aws::S3::Model::GetObjectRequest request;
+    request.SetBucket(argObjKey.bucketA());
+    request.SetKey(argObjKey.keyA());
+    request.SetRange(range);
+
+    if (!argETag.empty())
+    {
+        // Õp[gƓł̓êƂ擾
+        // --> [gXVĂ 412 Ŏs
+
+        request.SetIfMatch(WC2MB(argETag));
+    }
+
+    const auto outcome = executeWithRetry(mS3Client, &Aws::S3::S3Client::GetObject, request, mRuntimeEnv->MaxApiRetryCount);
+    if (!IsSuccess(outcome))
+    {
+        errorW(L"fault: GetObject argObjKey=%s argETag=%s", argObjKey.c_str(), argETag.c_str());
+        return OutcomeIsHttpCode412(outcome) ? FILEIO_LENGTH_ETAG_MISMATCH : -1LL;
+    }
+
+    const auto& result{ outcome.GetResult() };
+    const auto contentLength = result.GetContentLength();
+
+    if (argLength != result.GetContentLength())
+    {
+        errorW(L"fault: unmatch argLength=%lld result=%lld", argLength, contentLength);
+        return -1LL;
+    }
+
+    // result ̓eobt@ɏo͂
+
+    auto& body{ result.GetBody() };
+
+    return writeBufferFromStream(CONT_CALLER argOutputBuffer, &body, contentLength);
+}
+
 }   // namespace CSESS3
 
 // EOF
\ No newline at end of file
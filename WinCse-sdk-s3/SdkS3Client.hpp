@@ -16,12 +16,18 @@ using UploadFilePartType = CSELIB::FilePart<std::optional<Aws::String>>;
 
 class SdkS3Client : public CSEDVC::IApiClient
 {
+	friend class SdkS3StreamUpload;
+
 protected:
 	CSELIB::IWorker* const				mDelayedWorker;
 	const CSEDVC::RuntimeEnv* const		mRuntimeEnv;
 	std::wstring						mClientRegion;
 	Aws::S3::S3Client* const			mS3Client;
 
+	// }`p[gEAbv[h̃p[gTCYƓs
+
+	CSELIB::TransferTuner				mUploadTuner;
+
 	virtual std::string getDefaultBucketRegion() const
 	{
 		// ÂoPbgi2008NȑOj
@@ -33,6 +39,13 @@ protected:
 
 	WINCSESDKS3_API bool uploadSimple(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath);
 	WINCSESDKS3_API bool PutObjectInternal(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath);
+	WINCSESDKS3_API bool uploadParts(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath,
+		const std::list<std::shared_ptr<UploadFilePartType>>& argFileParts, const Aws::String& argSourceETag, const std::set<int>& argCopyPartNumbers);
+	WINCSESDKS3_API std::optional<Aws::String> createMultipartUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath);
+	WINCSESDKS3_API bool waitUploadParts(CALLER_ARG const std::list<std::shared_ptr<UploadFilePartType>>& argFileParts);
+	WINCSESDKS3_API std::optional<Aws::String> completeMultipartUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const Aws::String& argUploadId, const std::list<std::shared_ptr<UploadFilePartType>>& argFileParts);
+	WINCSESDKS3_API void abortMultipartUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const Aws::String& argUploadId);
+	WINCSESDKS3_API bool replaceMetadata(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath, const Aws::String& argSourceETag);
 
 public:
 	SdkS3Client(const CSEDVC::RuntimeEnv* argRuntimeEnv, CSELIB::IWorker* argDelayedWorker, const std::wstring& argClientRegion, Aws::S3::S3Client* argS3Client)
@@ -42,6 +55,11 @@ public:
 		mClientRegion(argClientRegion),
 		mS3Client(argS3Client)
 	{
+		mUploadTuner.init(mRuntimeEnv->TransferAutoTune,
+			CSELIB::FILESIZE_1MiBll * mRuntimeEnv->TransferWriteSizeMib,
+			CSELIB::FILESIZE_1MiBll * mRuntimeEnv->TransferMinSizeMib,
+			CSELIB::FILESIZE_1MiBll * mRuntimeEnv->TransferMaxSizeMib,
+			mRuntimeEnv->TransferMaxParallel);
 	}
 
 	bool canAccessRegion(CALLER_ARG const std::wstring& argBucketRegion) override
@@ -66,6 +84,9 @@ public:
 	WINCSESDKS3_API std::optional<Aws::String> uploadPart(CALLER_ARG const CSELIB::ObjectKey& argObjKey,
 		const std::filesystem::path& argInputPath, const Aws::String& argUploadId, const std::shared_ptr<UploadFilePartType>& argFilePart);
 
+	WINCSESDKS3_API std::optional<Aws::String> uploadPartCopy(CALLER_ARG const CSELIB::ObjectKey& argObjKey,
+		const Aws::String& argSourceETag, const Aws::String& argUploadId, const std::shared_ptr<UploadFilePartType>& argFilePart);
+
 	// AWS SDK API s
 
 	WINCSESDKS3_API bool ListBuckets(CALLER_ARG CSELIB::DirEntryListType* pDirEntryList) override;
@@ -75,8 +96,11 @@ public:
 	WINCSESDKS3_API bool DeleteObjects(CALLER_ARG const std::wstring& argBucket, const std::list<std::wstring>& argKeys) override;
 	WINCSESDKS3_API bool DeleteObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey) override;
 	WINCSESDKS3_API bool PutObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath) override;
+	WINCSESDKS3_API bool PutObjectPartial(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath, const std::wstring& argSourceETag, const std::list<CSELIB::UploadRange>& argRanges) override;
+	WINCSESDKS3_API std::unique_ptr<CSELIB::IStreamUpload> BeginStreamUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath) override;
 	WINCSESDKS3_API bool CopyObject(CALLER_ARG const CSELIB::ObjectKey& argSrcObjKey, const CSELIB::ObjectKey& argDstObjKey) override;
-	WINCSESDKS3_API CSELIB::FILEIO_LENGTH_T GetObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) override;
+	WINCSESDKS3_API CSELIB::FILEIO_LENGTH_T GetObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) override;
+	WINCSESDKS3_API CSELIB::FILEIO_LENGTH_T GetObjectAndWriteBuffer(CALLER_ARG const CSELIB::ObjectKey& argObjKey, PVOID argOutputBuffer, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) override;
 };
 
 }	// namespace CSESS3
@@ -87,6 +111,12 @@ bool OutcomeIsHttpCode404(const OutcomeT& outcome)
 	return outcome.GetError().GetResponseCode() == Aws::Http::HttpResponseCode::NOT_FOUND;
 }
 
+template<typename OutcomeT>
+bool OutcomeIsHttpCode412(const OutcomeT& outcome)
+{
+	return outcome.GetError().GetResponseCode() == Aws::Http::HttpResponseCode::PRECONDITION_FAILED;
+}
+
 template<typename OutcomeT>
 bool IsSuccess(const OutcomeT& outcome)
 {
@@ -4,25 +4,176 @@
 using namespace CSELIB;
 using namespace CSEDVC;
 
-static std::shared_ptr<Aws::StringStream> makeStreamFromFile(CALLER_ARG const std::filesystem::path& argInputPath,
+//
+// LbVt@C͈̔͂ǂݎXg[
+//
+// NGXg̖{̂ƂāA͈͂̓eɃRs[Ƀt@C璼ړǂݎB
+// ǂݎ͌ŒTCỸobt@PʂōŝŁAp[gTCYɂ炸̎gpʂ͈ɂȂB
+// SDK ͍đ`FbNŤvZŐ擪ɖ߂̂ŁÃ͈͓V[NɑΉ
+//
+
+class FileRegionStreamBuf final : public std::streambuf
+{
+    FileHandle mFile;
+    const FILEIO_OFFSET_T mOffset;
+    const FILEIO_LENGTH_T mLength;
+
+    // obt@̏I[ɑΉA͈͂̐擪̈ʒu
+
+    FILEIO_LENGTH_T mPosition = 0LL;
+
+    std::vector<char> mBuffer;
+
+public:
+    FileRegionStreamBuf(FileHandle&& argFile, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength)
+        :
+        mFile(std::move(argFile)),
+        mOffset(argOffset),
+        mLength(argLength),
+        mBuffer(static_cast<size_t>(min(static_cast<FILEIO_LENGTH_T>(FILEIO_BUFFER_SIZE), max(argLength, 1LL))))
+    {
+    }
+
+protected:
+    int_type underflow() override
+    {
+        if (gptr() < egptr())
+        {
+            return traits_type::to_int_type(*gptr());
+        }
+
+        if (mPosition >= mLength)
+        {
+            return traits_type::eof();
+        }
+
+        // t@CE|C^g킸ɁAʒuw肵ēǂݎ
+
+        const auto readOffset = mOffset + mPosition;
+        const auto readLength = static_cast<DWORD>(min(static_cast<FILEIO_LENGTH_T>(mBuffer.size()), mLength - mPosition));
+
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(readOffset);
+        overlapped.OffsetHigh = static_cast<DWORD>(readOffset >> 32);
+
+        DWORD bytesRead = 0;
+
+        if (!::ReadFile(mFile.handle(), mBuffer.data(), readLength, &bytesRead, &overlapped) || bytesRead == 0)
+        {
+            return traits_type::eof();
+        }
+
+        setg(mBuffer.data(), mBuffer.data(), mBuffer.data() + bytesRead);
+        mPosition += bytesRead;
+
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize showmanyc() override
+    {
+        return static_cast<std::streamsize>(mLength - mPosition);
+    }
+
+    pos_type seekoff(off_type argOff, std::ios_base::seekdir argDir, std::ios_base::openmode argWhich) override
+    {
+        off_type base = 0;
+
+        if (argDir == std::ios_base::cur)
+        {
+            base = static_cast<off_type>(mPosition - (egptr() - gptr()));
+        }
+        else if (argDir == std::ios_base::end)
+        {
+            base = static_cast<off_type>(mLength);
+        }
+
+        return this->seekpos(pos_type(base + argOff), argWhich);
+    }
+
+    pos_type seekpos(pos_type argPos, std::ios_base::openmode argWhich) override
+    {
+        const auto newPosition = static_cast<FILEIO_LENGTH_T>(off_type(argPos));
+
+        if (!(argWhich & std::ios_base::in) || newPosition < 0 || newPosition > mLength)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        // obt@ɓǂݍݍς̈ʒuł΁AǂݒȂ
+
+        const auto bufferBegin = mPosition - (egptr() - eback());
+
+        if (bufferBegin <= newPosition && newPosition < mPosition)
+        {
+            setg(eback(), eback() + (newPosition - bufferBegin), egptr());
+        }
+        else
+        {
+            setg(nullptr, nullptr, nullptr);
+            mPosition = newPosition;
+        }
+
+        return argPos;
+    }
+};
+
+class FileRegionStream final : public Aws::IOStream
+{
+    FileRegionStreamBuf mStreamBuf;
+
+public:
+    FileRegionStream(FileHandle&& argFile, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength)
+        :
+        Aws::IOStream(nullptr),
+        mStreamBuf(std::move(argFile), argOffset, argLength)
+    {
+        this->rdbuf(&mStreamBuf);
+    }
+};
+
+static std::shared_ptr<Aws::IOStream> makeStreamFromFile(CALLER_ARG const std::filesystem::path& argInputPath,
     FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength)
 {
     NEW_LOG_BLOCK();
 
-    auto stream = Aws::MakeShared<Aws::StringStream>("UploadSimpleStream");
+    FileHandle file = ::CreateFileW(
+        argInputPath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        NULL);
+
+    if (file.invalid())
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: CreateFileW lerr=%lu argInputPath=%s", lerr, argInputPath.c_str());
+        return nullptr;
+    }
+
+    // ͈͂t@CɎ܂Ă邱
 
-    const auto nWrite = writeStreamFromFile(CONT_CALLER stream.get(), argInputPath, argOffset, argLength);
-    if (nWrite != argLength)
+    LARGE_INTEGER fileSize{};
+
+    if (!::GetFileSizeEx(file.handle(), &fileSize))
     {
-        errorW(L"fault: writeStreamFromFile argInputPath=%s", argInputPath.c_str());
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: GetFileSizeEx lerr=%lu argInputPath=%s", lerr, argInputPath.c_str());
         return nullptr;
     }
 
-    traceW(L"stream length=%llu", stream->str().size());
+    if (fileSize.QuadPart < argOffset + argLength)
+    {
+        errorW(L"fault: out of range fileSize=%lld argOffset=%lld argLength=%lld", fileSize.QuadPart, argOffset, argLength);
+        return nullptr;
+    }
 
-    APP_ASSERT(static_cast<FILEIO_LENGTH_T>(stream->str().size()) == argLength);
+    traceW(L"stream argOffset=%lld argLength=%lld", argOffset, argLength);
 
-    return stream;
+    return Aws::MakeShared<FileRegionStream>("UploadFileStream", std::move(file), argOffset, argLength);
 }
 
 namespace CSESS3 {
@@ -103,18 +254,24 @@ struct UploadFilePartTask : public IOnDemandTask
     Aws::String mUploadId;
     std::shared_ptr<UploadFilePartType> mFilePart;
 
+    // łȂ΁At@Cł͂Ȃ ETag ̃[g̓eRs[
+
+    const Aws::String mCopySourceETag;
+
     UploadFilePartTask(
         SdkS3Client* argThat,
         const ObjectKey& argObjKey,
         const std::filesystem::path& argInputPath,
         const Aws::String& argUploadId,
-        const std::shared_ptr<UploadFilePartType>& argFilePart)
+        const std::shared_ptr<UploadFilePartType>& argFilePart,
+        const Aws::String& argCopySourceETag)
         :
         mThat(argThat),
         mObjKey(argObjKey),
         mInputPath(argInputPath),
         mUploadId(argUploadId),
-        mFilePart(argFilePart)
+        mFilePart(argFilePart),
+        mCopySourceETag(argCopySourceETag)
     {
     }
 
@@ -130,10 +287,14 @@ struct UploadFilePartTask : public IOnDemandTask
             {
                 errorW(L"@%d Interruption request received", argThreadIndex);
             }
-            else
+            else if (mCopySourceETag.empty())
             {
                 result = mThat->uploadPart(START_CALLER mObjKey, mInputPath, mUploadId, mFilePart);
             }
+            else
+            {
+                result = mThat->uploadPartCopy(START_CALLER mObjKey, mCopySourceETag, mUploadId, mFilePart);
+            }
         }
         catch (const std::exception& ex)
         {
@@ -172,12 +333,16 @@ std::optional<Aws::String> SdkS3Client::uploadPart(CALLER_ARG
 
     // Content-Length
 
-    //uploadRequest.SetContentLength(argFilePart->mLength);
+    uploadRequest.SetContentLength(argFilePart->mLength);
 
     // Body
 
     uploadRequest.SetBody(body);
 
+    // ɓ]p[g̘g󂭂܂ő҂
+
+    TransferTuner::Slot slot{ &mUploadTuner };
+
     const auto uploadOutcome = executeWithRetry(mS3Client, &Aws::S3::S3Client::UploadPart, uploadRequest, mRuntimeEnv->MaxApiRetryCount);
 
     if (!IsSuccess(uploadOutcome))
@@ -185,16 +350,56 @@ std::optional<Aws::String> SdkS3Client::uploadPart(CALLER_ARG
         errorW(L"fault: argObjKey=%s partNumber=%d", argObjKey.c_str(), argFilePart->mPartNumber);
 
         // Abort on failure
-        Aws::S3::Model::AbortMultipartUploadRequest abortRequest;
-        abortRequest.WithBucket(argObjKey.bucketA()).WithKey(argObjKey.keyA()).WithUploadId(argUploadId);
-        mS3Client->AbortMultipartUpload(abortRequest);
+        this->abortMultipartUpload(CONT_CALLER argObjKey, argUploadId);
 
         return std::nullopt;
     }
 
+    // p[gTCYƓs̒ɗp
+
+    slot.complete(argFilePart->mLength);
+
     return uploadOutcome.GetResult().GetETag();
 }
 
+std::optional<Aws::String> SdkS3Client::uploadPartCopy(CALLER_ARG
+    const ObjectKey& argObjKey, const Aws::String& argSourceETag, const Aws::String& argUploadId,
+    const std::shared_ptr<UploadFilePartType>& argFilePart)
+{
+    NEW_LOG_BLOCK();
+
+    Aws::S3::Model::UploadPartCopyRequest copyRequest;
+
+    copyRequest.WithBucket(argObjKey.bucketA()).WithKey(argObjKey.keyA())
+        .WithUploadId(argUploadId).WithPartNumber(argFilePart->mPartNumber);
+
+    // IuWFNg̕ύXO̓eAp[g͈̔͂Rs[
+    // --> Ń[gXVĂ ETag ̏ŎŝŁAʂ̓e邱Ƃ͂Ȃ
+
+    std::ostringstream range;
+    range << "bytes=" << argFilePart->mOffset << '-' << (argFilePart->mOffset + argFilePart->mLength - 1);
+
+    copyRequest.SetCopySource(argObjKey.strA());
+    copyRequest.SetCopySourceRange(range.str());
+    copyRequest.SetCopySourceIfMatch(argSourceETag);
+
+    // T[oł̃Rs[Ȃ̂ŁA]̘g͎gȂ
+
+    const auto copyOutcome = executeWithRetry(mS3Client, &Aws::S3::S3Client::UploadPartCopy, copyRequest, mRuntimeEnv->MaxApiRetryCount);
+
+    if (!IsSuccess(copyOutcome))
+    {
+        errorW(L"fault: argObjKey=%s partNumber=%d", argObjKey.c_str(), argFilePart->mPartNumber);
+
+        // Abort on failure
+        this->abortMultipartUpload(CONT_CALLER argObjKey, argUploadId);
+
+        return std::nullopt;
+    }
+
+    return copyOutcome.GetResult().GetCopyPartResult().GetETag();
+}
+
 bool SdkS3Client::PutObjectInternal(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
 {
     NEW_LOG_BLOCK();
@@ -213,7 +418,11 @@ bool SdkS3Client::PutObjectInternal(CALLER_ARG const ObjectKey& argObjKey, const
 
     traceW(L"fileSize=%lld", fileSize);
 
-    const auto PART_SIZE_BYTE = FILESIZE_1MiBll * mRuntimeEnv->TransferWriteSizeMib;
+    // ߂̃Abv[ȟʂŒꂽp[gTCY
+
+    const auto PART_SIZE_BYTE = mUploadTuner.getPartSize();
+
+    traceW(L"mUploadTuner=%s", mUploadTuner.str().c_str());
 
     // Abv[ḧ쐬
 
@@ -238,13 +447,120 @@ bool SdkS3Client::PutObjectInternal(CALLER_ARG const ObjectKey& argObjKey, const
         fileParts.push_back(std::make_shared<UploadFilePartType>(partNumber, partOffset, partLength, std::nullopt));
     }
 
+    return this->uploadParts(CONT_CALLER argObjKey, argFileInfo, argInputPath, fileParts, "", {});
+}
+
+bool SdkS3Client::PutObjectPartial(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath,
+    const std::wstring& argSourceETag, const std::list<UploadRange>& argRanges)
+{
+    NEW_LOG_BLOCK();
+    APP_ASSERT(argObjKey.isObject());
+    APP_ASSERT(argInputPath);
+
+    traceW(L"argObjKey=%s argFileInfo=%s argInputPath=%s argSourceETag=%s",
+        argObjKey.c_str(), FileInfoToStringW(argFileInfo).c_str(), argInputPath, argSourceETag.c_str());
+
+    // UploadPartCopy ňxɃRs[łTCYƁA}`p[gEAbv[h̃p[g̏
+
+    const FILEIO_LENGTH_T MAX_COPY_PART_SIZE = FILESIZE_1GiBll * 5;
+    const size_t MAX_PART_COUNT = 10000;
+
+    // ߂̃Abv[ȟʂŒꂽp[gTCY
+
+    const auto PART_SIZE_BYTE = mUploadTuner.getPartSize();
+
+    traceW(L"mUploadTuner=%s", mUploadTuner.str().c_str());
+
+    // ͈͂ƂɃp[g쐬
+    // --> ͈͍͂Ō̂̂čŏ̃p[gTCYȏȂ̂ŁA͈͂̓p[gTCYŊ؂Ȃ
+    //     ep[gɕzARs[͈͂͏𒴂Ȃ悤ɓ
+
+    std::list<std::shared_ptr<UploadFilePartType>> fileParts;
+    std::set<int> copyPartNumbers;
+
+    for (const auto& range: argRanges)
+    {
+        const auto count = range.mCopy ? UNIT_COUNT(range.mLength, MAX_COPY_PART_SIZE) : max(range.mLength / PART_SIZE_BYTE, 1LL);
+        const auto partSize = range.mLength / count;
+
+        for (int i=0; i<count; ++i)
+        {
+            const auto partNumber = static_cast<int>(fileParts.size()) + 1;
+            const auto partOffset = range.mOffset + i * partSize;
+            const auto partLength = i == count - 1 ? range.mOffset + range.mLength - partOffset : partSize;
+
+            fileParts.push_back(std::make_shared<UploadFilePartType>(partNumber, partOffset, partLength, std::nullopt));
+
+            if (range.mCopy)
+            {
+                copyPartNumbers.insert(partNumber);
+            }
+        }
+    }
+
+    if (fileParts.empty() || fileParts.size() > MAX_PART_COUNT)
+    {
+        traceW(L"fault: fileParts.size=%zu", fileParts.size());
+        return false;
+    }
+
+    traceW(L"fileParts.size=%zu copyPartNumbers.size=%zu", fileParts.size(), copyPartNumbers.size());
+
+    return this->uploadParts(CONT_CALLER argObjKey, argFileInfo, argInputPath, fileParts, WC2MB(argSourceETag), copyPartNumbers);
+}
+
+bool SdkS3Client::uploadParts(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath,
+    const std::list<std::shared_ptr<UploadFilePartType>>& argFileParts, const Aws::String& argSourceETag, const std::set<int>& argCopyPartNumbers)
+{
+    NEW_LOG_BLOCK();
+
     // }`p[gEAbv[h̏
 
-    const auto bucketName{ argObjKey.bucketA() };
-    const auto objectName{ argObjKey.keyA() };
+    const auto uploadId{ this->createMultipartUpload(CONT_CALLER argObjKey, argFileInfo, argInputPath) };
+    if (!uploadId)
+    {
+        errorW(L"fault: createMultipartUpload argObjKey=%s", argObjKey.c_str());
+        return false;
+    }
+
+    // p[gƂɃ^XN𐶐
+
+    for (const auto& filePart: argFileParts)
+    {
+        traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+        const auto isCopy = argCopyPartNumbers.find(filePart->mPartNumber) != argCopyPartNumbers.cend();
+
+        mDelayedWorker->addTask(new UploadFilePartTask{ this, argObjKey, argInputPath, *uploadId, filePart, isCopy ? argSourceETag : "" });
+    }
+
+    // ^XN̊҂
+
+    if (!this->waitUploadParts(CONT_CALLER argFileParts))
+    {
+        traceW(L"error exists");
+        return false;
+    }
+
+    // Abv[hʂ擾
+
+    if (!this->completeMultipartUpload(CONT_CALLER argObjKey, *uploadId, argFileParts))
+    {
+        errorW(L"fault: completeMultipartUpload argObjKey=%s", argObjKey.c_str());
+        return false;
+    }
+
+    traceW(L"Upload completed successfully.");
+
+    return true;
+}
+
+std::optional<Aws::String> SdkS3Client::createMultipartUpload(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
+{
+    NEW_LOG_BLOCK();
 
     Aws::S3::Model::CreateMultipartUploadRequest createRequest;
-    createRequest.WithBucket(bucketName).WithKey(objectName);
+    createRequest.WithBucket(argObjKey.bucketA()).WithKey(argObjKey.keyA());
 
     // ^f[^ݒ
 
@@ -261,30 +577,21 @@ bool SdkS3Client::PutObjectInternal(CALLER_ARG const ObjectKey& argObjKey, const
     if (!IsSuccess(createOutcome))
     {
         errorW(L"fault: CreateMultipartUpload argObjKey=%s", argObjKey.c_str());
-        return false;
-    }
-
-    // p[gƂɃ^XN𐶐
-
-    const auto& uploadId{ createOutcome.GetResult().GetUploadId() };
-
-    for (const auto& filePart: fileParts)
-    {
-        traceW(L"addTask filePart=%s", filePart->str().c_str());
-
-        mDelayedWorker->addTask(new UploadFilePartTask{ this, argObjKey, argInputPath, uploadId, filePart });
+        return std::nullopt;
     }
 
-    // ^XN̊҂
+    return createOutcome.GetResult().GetUploadId();
+}
 
-    std::vector<Aws::S3::Model::CompletedPart> completedParts(partCount);
+bool SdkS3Client::waitUploadParts(CALLER_ARG const std::list<std::shared_ptr<UploadFilePartType>>& argFileParts)
+{
+    NEW_LOG_BLOCK();
 
     bool errorExists = false;
-    int i = 0;
 
-    for (const auto& filePart: fileParts)
+    for (const auto& filePart: argFileParts)
     {
-        auto result{ filePart->getResult() };
+        const auto result{ filePart->getResult() };
 
         if (!result)
         {
@@ -293,63 +600,330 @@ bool SdkS3Client::PutObjectInternal(CALLER_ARG const ObjectKey& argObjKey, const
             errorW(L"fault: mPartNumber=%d", filePart->mPartNumber);
             break;
         }
+    }
 
-        completedParts[i].WithPartNumber(filePart->mPartNumber).WithETag(*result);
+    if (!errorExists)
+    {
+        return true;
+    }
+
+    // }`p[g̈ꕔɃG[݂̂ŁASĂ̒x^XN𒆒fďI
+
+    for (auto& filePart: argFileParts)
+    {
+        // SẴp[gɒftO𗧂Ă
+
+        traceW(L"set mInterrupt mPartNumber=%lld", filePart->mPartNumber);
 
-        i++;
+        filePart->mInterrupt = true;
     }
 
-    if (errorExists)
+    for (auto& filePart: argFileParts)
     {
-        // }`p[g̈ꕔɃG[݂̂ŁASĂ̒x^XN𒆒fďI
+        // ^XN̊ҋ@
 
-        for (auto& filePart: fileParts)
+        const auto result = filePart->getResult();
+        if (!result)
         {
-            // SẴp[gɒftO𗧂Ă
+            errorW(L"fault: mPartNumber=%d", filePart->mPartNumber);
+        }
+    }
+
+    return false;
+}
 
-            traceW(L"set mInterrupt mPartNumber=%lld", filePart->mPartNumber);
+std::optional<Aws::String> SdkS3Client::completeMultipartUpload(CALLER_ARG const ObjectKey& argObjKey, const Aws::String& argUploadId,
+    const std::list<std::shared_ptr<UploadFilePartType>>& argFileParts)
+{
+    NEW_LOG_BLOCK();
 
-            filePart->mInterrupt = true;
-        }
+    // SẴp[gĂ邱
 
-        for (auto& filePart: fileParts)
-        {
-            // ^XN̊ҋ@
+    std::vector<Aws::S3::Model::CompletedPart> completedParts;
 
-            const auto result = filePart->getResult();
-            if (!result)
-            {
-                errorW(L"fault: mPartNumber=%d", filePart->mPartNumber);
-            }
-        }
+    for (const auto& filePart: argFileParts)
+    {
+        const auto result{ filePart->getResult() };
+        APP_ASSERT(result);
 
-        traceW(L"error exists");
-        return false;
+        completedParts.push_back(Aws::S3::Model::CompletedPart{}.WithPartNumber(filePart->mPartNumber).WithETag(*result));
     }
 
-    // Abv[hʂ擾
-
     Aws::S3::Model::CompletedMultipartUpload completedUpload;
     completedUpload.WithParts(completedParts);
 
     Aws::S3::Model::CompleteMultipartUploadRequest completeRequest;
-    completeRequest.WithBucket(bucketName)
-        .WithKey(objectName)
-        .WithUploadId(uploadId)
+    completeRequest.WithBucket(argObjKey.bucketA())
+        .WithKey(argObjKey.keyA())
+        .WithUploadId(argUploadId)
         .WithMultipartUpload(completedUpload);
 
     const auto completeOutcome = mS3Client->CompleteMultipartUpload(completeRequest);
     if (!IsSuccess(completeOutcome))
     {
         errorW(L"fault: CompleteMultipartUpload argObjKey=%s", argObjKey.c_str());
+        return std::nullopt;
+    }
+
+    return completeOutcome.GetResult().GetETag();
+}
+
+void SdkS3Client::abortMultipartUpload(CALLER_ARG const ObjectKey& argObjKey, const Aws::String& argUploadId)
+{
+    NEW_LOG_BLOCK();
+
+    Aws::S3::Model::AbortMultipartUploadRequest abortRequest;
+    abortRequest.WithBucket(argObjKey.bucketA()).WithKey(argObjKey.keyA()).WithUploadId(argUploadId);
+
+    const auto abortOutcome = mS3Client->AbortMultipartUpload(abortRequest);
+    if (!IsSuccess(abortOutcome))
+    {
+        traceW(L"fault: AbortMultipartUpload argObjKey=%s", argObjKey.c_str());
+    }
+}
+
+bool SdkS3Client::replaceMetadata(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath, const Aws::String& argSourceETag)
+{
+    NEW_LOG_BLOCK();
+    APP_ASSERT(argObjKey.isObject());
+
+    // CopyObject ňxɃRs[łTCY
+
+    const FILEIO_LENGTH_T MAX_COPY_OBJECT_SIZE = FILESIZE_1GiBll * 5;
+
+    const auto fileSize = static_cast<FILEIO_LENGTH_T>(argFileInfo.FileSize);
+
+    if (fileSize > MAX_COPY_OBJECT_SIZE)
+    {
+        // 傫Ȃ̂̓p[gƂ̃T[õRs[Œu
+
+        const std::list<UploadRange> ranges{ { 0LL, fileSize, true } };
+
+        return this->PutObjectPartial(CONT_CALLER argObjKey, argFileInfo, argInputPath, MB2WC(argSourceETag), ranges);
+    }
+
+    // IuWFNgւ̃Rs[Ń^f[^u
+    // --> REPLACE ł Content-Type pȂ̂ŁA߂Đݒ肷
+
+    Aws::S3::Model::CopyObjectRequest request;
+
+    request.SetCopySource(argObjKey.strA());
+    request.SetCopySourceIfMatch(argSourceETag);
+    request.SetBucket(argObjKey.bucketA());
+    request.SetKey(argObjKey.keyA());
+    request.SetMetadataDirective(Aws::S3::Model::MetadataDirective::REPLACE);
+
+    Aws::Map<Aws::String, Aws::String> metadata;
+    setMetadataFromFileInfo(CONT_CALLER argFileInfo, &metadata);
+    request.SetMetadata(metadata);
+
+    const auto contentType{ getContentType(CONT_CALLER argFileInfo.FileSize, argInputPath, argObjKey.key()) };
+    request.SetContentType(WC2MB(contentType));
+
+    const auto outcome = executeWithRetry(mS3Client, &Aws::S3::S3Client::CopyObject, request, mRuntimeEnv->MaxApiRetryCount);
+
+    if (!IsSuccess(outcome))
+    {
+        errorW(L"fault: CopyObject argObjKey=%s", argObjKey.c_str());
         return false;
     }
 
-    traceW(L"Upload completed successfully.");
+    traceW(L"success: CopyObject argObjKey=%s", argObjKey.c_str());
 
     return true;
 }
 
+//
+// ݂ƕsĐi߂}`p[gEAbv[h
+//
+// 擪珑܂ꂽp[gTCYɒB邲ƂɁÃp[g̃Abv[h
+// ^XNƂēo^Bŏ̃p[gɒB܂ł̓}`p[gEAbv[hJnA
+// Ƀp[gȂΒʏ̃Abv[hsB
+//
+// ^f[^͊Jñt@CŐݒ肳̂ŁAɓIuWFNg
+// T[õRs[Ŋ̃t@Cɒu
+//
+
+class SdkS3StreamUpload final : public IStreamUpload
+{
+    SdkS3Client* const mThat;
+    const ObjectKey mObjKey;
+    const FSP_FSCTL_FILE_INFO mFileInfo;
+    const std::wstring mInputPath;
+
+    // rŃp[gTCYĂÃAbv[h̒ł͕ςȂ
+
+    const FILEIO_LENGTH_T mPartSize;
+
+    Aws::String mUploadId;
+    std::list<std::shared_ptr<UploadFilePartType>> mFileParts;
+    FILEIO_LENGTH_T mQueuedLength = 0LL;
+    bool mCompleted = false;
+
+    bool addPart(CALLER_ARG FILEIO_LENGTH_T argLength)
+    {
+        NEW_LOG_BLOCK();
+
+        // }`p[gEAbv[h̃p[g̏
+
+        const size_t MAX_PART_COUNT = 10000;
+
+        if (mFileParts.size() >= MAX_PART_COUNT)
+        {
+            traceW(L"fault: mFileParts.size=%zu", mFileParts.size());
+            return false;
+        }
+
+        const auto partNumber = static_cast<int>(mFileParts.size()) + 1;
+        const auto filePart{ std::make_shared<UploadFilePartType>(partNumber, mQueuedLength, argLength, std::nullopt) };
+
+        traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+        mThat->mDelayedWorker->addTask(new UploadFilePartTask{ mThat, mObjKey, mInputPath, mUploadId, filePart, "" });
+
+        mFileParts.push_back(filePart);
+        mQueuedLength += argLength;
+
+        return true;
+    }
+
+public:
+    SdkS3StreamUpload(SdkS3Client* argThat, const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
+        :
+        mThat(argThat),
+        mObjKey(argObjKey),
+        mFileInfo(argFileInfo),
+        mInputPath(argInputPath),
+        mPartSize(argThat->mUploadTuner.getPartSize())
+    {
+    }
+
+    ~SdkS3StreamUpload()
+    {
+        if (mCompleted || mUploadId.empty())
+        {
+            return;
+        }
+
+        // ĂȂ̂ŁAo^p[g𒆒fĔj
+        // --> s̃p[g̓Abv[h̒fɂ莸ŝŁA͑҂Ȃ
+
+        for (auto& filePart: mFileParts)
+        {
+            filePart->mInterrupt = true;
+        }
+
+        mThat->abortMultipartUpload(START_CALLER mObjKey, mUploadId);
+    }
+
+    bool started() const override
+    {
+        return !mUploadId.empty() && !mFileParts.empty();
+    }
+
+    bool advance(CALLER_ARG FILEIO_LENGTH_T argWrittenLength) override
+    {
+        NEW_LOG_BLOCK();
+
+        while (argWrittenLength - mQueuedLength >= mPartSize)
+        {
+            if (mUploadId.empty())
+            {
+                const auto uploadId{ mThat->createMultipartUpload(CONT_CALLER mObjKey, mFileInfo, mInputPath.c_str()) };
+                if (!uploadId)
+                {
+                    errorW(L"fault: createMultipartUpload mObjKey=%s", mObjKey.c_str());
+                    return false;
+                }
+
+                mUploadId = *uploadId;
+            }
+
+            if (!this->addPart(CONT_CALLER mPartSize))
+            {
+                errorW(L"fault: addPart mObjKey=%s", mObjKey.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool complete(CALLER_ARG const FSP_FSCTL_FILE_INFO& argFileInfo) override
+    {
+        NEW_LOG_BLOCK();
+        APP_ASSERT(!mCompleted);
+
+        traceW(L"mObjKey=%s argFileInfo=%s mQueuedLength=%lld", mObjKey.c_str(), FileInfoToStringW(argFileInfo).c_str(), mQueuedLength);
+
+        if (mUploadId.empty())
+        {
+            // p[gTCYɒBȂ̂ŁAʏ̃Abv[hs
+
+            mCompleted = true;
+
+            return mThat->PutObjectInternal(CONT_CALLER mObjKey, argFileInfo, mInputPath.c_str());
+        }
+
+        const auto fileSize = static_cast<FILEIO_LENGTH_T>(argFileInfo.FileSize);
+        if (fileSize < mQueuedLength)
+        {
+            errorW(L"fault: fileSize=%lld mQueuedLength=%lld", fileSize, mQueuedLength);
+            return false;
+        }
+
+        // c̕p[gƂēo^
+
+        while (mQueuedLength < fileSize)
+        {
+            if (!this->addPart(CONT_CALLER min(mPartSize, fileSize - mQueuedLength)))
+            {
+                errorW(L"fault: addPart mObjKey=%s", mObjKey.c_str());
+                return false;
+            }
+        }
+
+        if (!mThat->waitUploadParts(CONT_CALLER mFileParts))
+        {
+            errorW(L"fault: waitUploadParts mObjKey=%s", mObjKey.c_str());
+            return false;
+        }
+
+        const auto etag{ mThat->completeMultipartUpload(CONT_CALLER mObjKey, mUploadId, mFileParts) };
+        if (!etag)
+        {
+            errorW(L"fault: completeMultipartUpload mObjKey=%s", mObjKey.c_str());
+            return false;
+        }
+
+        mCompleted = true;
+
+        // ̃t@CŃ^f[^u
+        // --> ݂ɂXVȂǂJn̒lςĂ̂ŁAɔf
+        // --> e͑MςȂ̂ŁAsĂAbv[h͐Ƃ
+
+        if (!mThat->replaceMetadata(CONT_CALLER mObjKey, argFileInfo, mInputPath.c_str(), *etag))
+        {
+            errorW(L"fault: replaceMetadata mObjKey=%s", mObjKey.c_str());
+        }
+
+        traceW(L"Upload completed successfully.");
+
+        return true;
+    }
+};
+
+std::unique_ptr<IStreamUpload> SdkS3Client::BeginStreamUpload(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
+{
+    NEW_LOG_BLOCK();
+    APP_ASSERT(argObjKey.isObject());
+    APP_ASSERT(argInputPath);
+
+    traceW(L"argObjKey=%s argInputPath=%s", argObjKey.c_str(), argInputPath);
+
+    return std::make_unique<SdkS3StreamUpload>(this, argObjKey, argFileInfo, argInputPath);
+}
+
 }   // namespace CSESS3
 
 // EOF
\ No newline at end of file
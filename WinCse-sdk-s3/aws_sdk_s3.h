@@ -32,6 +32,7 @@
 #include <aws/s3/model/CompletedMultipartUpload.h>
 #include <aws/s3/model/CompletedPart.h>
 #include <aws/s3/model/UploadPartRequest.h>
+#include <aws/s3/model/UploadPartCopyRequest.h>
 #pragma warning(pop)
 
 #undef USE_IMPORT_EXPORT
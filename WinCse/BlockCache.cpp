@@ -0,0 +1,223 @@
+#include "BlockCache.hpp"
+
+using namespace CSELIB;
+
+// }NɂKv͂ȂA킩₷̂
+
+#if defined(THREAD_SAFE)
+#error "THREAD_SAFFE(): already defined"
+#endif
+
+#define THREAD_SAFE()       std::lock_guard<std::mutex> lock_{ mGuard }
+
+namespace CSEDRV {
+
+void BlockCache::init(FILESIZE_T argCapacity)
+{
+    THREAD_SAFE();
+
+    const auto numBlocks = static_cast<size_t>(argCapacity / BLOCK_SIZE);
+
+    mFiles.clear();
+    mLru.clear();
+    mFreeSlots.clear();
+
+    mArena.resize(numBlocks * BLOCK_SIZE);
+    mArena.shrink_to_fit();
+
+    mBlocks.clear();
+    mBlocks.resize(numBlocks);
+
+    // 납ôŋtɐς
+
+    for (size_t i=numBlocks; i>0; i--)
+    {
+        mFreeSlots.push_back(i - 1);
+    }
+}
+
+void BlockCache::releaseSlot(size_t argSlot)
+{
+    auto& block{ mBlocks[argSlot] };
+
+    mLru.erase(block.mLru);
+
+    block = Block{};
+
+    mFreeSlots.push_back(argSlot);
+}
+
+bool BlockCache::get(const std::wstring& argWinPath, const std::wstring& argVersion, FILEIO_OFFSET_T argOffset, ULONG argLength, PVOID argBuffer)
+{
+    THREAD_SAFE();
+
+    if (argLength == 0)
+    {
+        return false;
+    }
+
+    const auto itFile{ mFiles.find(argWinPath) };
+    if (itFile == mFiles.end())
+    {
+        return false;
+    }
+
+    const auto& slots{ itFile->second };
+
+    const auto readEnd = argOffset + argLength;
+    const auto firstIndex = argOffset / BLOCK_SIZE;
+    const auto lastIndex = (readEnd - 1) / BLOCK_SIZE;
+
+    // ׂ͈͂̂ẴubNĂƂ̂ݕԂ
+
+    std::vector<size_t> hits;
+
+    for (auto blockIndex=firstIndex; blockIndex<=lastIndex; blockIndex++)
+    {
+        const auto it{ slots.find(blockIndex) };
+        if (it == slots.cend())
+        {
+            return false;
+        }
+
+        const auto& block{ mBlocks[it->second] };
+
+        if (block.mVersion != argVersion)
+        {
+            return false;
+        }
+
+        const auto blockEnd = blockIndex * BLOCK_SIZE + block.mLength;
+
+        if (blockEnd < min(readEnd, (blockIndex + 1) * BLOCK_SIZE))
+        {
+            // t@C̖܂ރubNŁAv͈̔͂ɑȂ
+
+            return false;
+        }
+
+        hits.push_back(it->second);
+    }
+
+    auto* dst = static_cast<BYTE*>(argBuffer);
+    auto offset = argOffset;
+
+    for (const auto slot: hits)
+    {
+        auto& block{ mBlocks[slot] };
+
+        const auto blockOffset = offset - block.mBlockIndex * BLOCK_SIZE;
+        const auto copyLength = min(readEnd - offset, BLOCK_SIZE - blockOffset);
+
+        memcpy(dst, slotData(slot) + blockOffset, static_cast<size_t>(copyLength));
+
+        dst += copyLength;
+        offset += copyLength;
+
+        mLru.splice(mLru.begin(), mLru, block.mLru);
+    }
+
+    return true;
+}
+
+void BlockCache::put(const std::wstring& argWinPath, const std::wstring& argVersion, FILEIO_OFFSET_T argBlockIndex, const BYTE* argData, ULONG argLength)
+{
+    APP_ASSERT(argLength <= BLOCK_SIZE);
+
+    THREAD_SAFE();
+
+    if (mBlocks.empty())
+    {
+        return;
+    }
+
+    auto& slots{ mFiles[argWinPath] };
+
+    size_t slot = 0;
+
+    const auto it{ slots.find(argBlockIndex) };
+    if (it != slots.end())
+    {
+        // ubN㏑
+
+        slot = it->second;
+
+        mLru.splice(mLru.begin(), mLru, mBlocks[slot].mLru);
+    }
+    else
+    {
+        if (mFreeSlots.empty())
+        {
+            // łÂubNǂo
+
+            const auto victim = mLru.back();
+            auto& victimBlock{ mBlocks[victim] };
+
+            const auto itVictimFile{ mFiles.find(victimBlock.mWinPath) };
+            APP_ASSERT(itVictimFile != mFiles.end());
+
+            itVictimFile->second.erase(victimBlock.mBlockIndex);
+
+            if (itVictimFile->second.empty() && &itVictimFile->second != &slots)
+            {
+                mFiles.erase(itVictimFile);
+            }
+
+            this->releaseSlot(victim);
+        }
+
+        slot = mFreeSlots.back();
+        mFreeSlots.pop_back();
+
+        mLru.push_front(slot);
+        mBlocks[slot].mLru = mLru.begin();
+
+        slots[argBlockIndex] = slot;
+    }
+
+    auto& block{ mBlocks[slot] };
+
+    block.mWinPath = argWinPath;
+    block.mVersion = argVersion;
+    block.mBlockIndex = argBlockIndex;
+    block.mLength = argLength;
+
+    memcpy(slotData(slot), argData, argLength);
+}
+
+void BlockCache::invalidate(const std::wstring& argWinPath)
+{
+    THREAD_SAFE();
+
+    const auto it{ mFiles.find(argWinPath) };
+    if (it == mFiles.end())
+    {
+        return;
+    }
+
+    for (const auto& slot: it->second)
+    {
+        this->releaseSlot(slot.second);
+    }
+
+    mFiles.erase(it);
+}
+
+std::wstring BlockCache::str() const
+{
+    THREAD_SAFE();
+
+    std::wostringstream ss;
+
+    ss << L"mBlocks.size=" << mBlocks.size();
+    ss << L" mFreeSlots.size=" << mFreeSlots.size();
+    ss << L" mFiles.size=" << mFiles.size();
+
+    return ss.str();
+}
+
+}   // namespace CSEDRV
+
+#undef THREAD_SAFE
+
+// EOF
\ No newline at end of file
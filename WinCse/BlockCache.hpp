@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+namespace CSEDRV
+{
+
+//
+// LbVt@C̓eubNPʂŃɕێ
+//
+// ӏJԂǂ Read (TlCt@CEwb_Ȃ) LbVt@C
+// ǂ܂ɕԂ߂ɗpB̈͋Nɂ܂Ƃ߂ĊmۂAubNPʂŎg񂷁B
+//
+// ubN Windows ̃pXƃ[g̔ (ETag Ȃ) ŎʂA[Jœe
+// ύXꂽƂ Windows ̃pXPʂŔj
+//
+
+class BlockCache final
+{
+public:
+	static constexpr CSELIB::FILEIO_LENGTH_T BLOCK_SIZE = CSELIB::FILESIZE_1MiBll;
+
+private:
+	struct Block
+	{
+		std::wstring			mWinPath;
+		std::wstring			mVersion;
+		CSELIB::FILEIO_OFFSET_T	mBlockIndex = -1LL;
+		ULONG					mLength = 0;
+		std::list<size_t>::iterator mLru;
+	};
+
+	std::vector<BYTE> mArena;
+	std::vector<Block> mBlocks;
+	std::vector<size_t> mFreeSlots;
+
+	// gp (擪łV)
+
+	std::list<size_t> mLru;
+
+	// Windows ̃pX -> ubNԍ -> Xbg
+
+	std::map<std::wstring, std::map<CSELIB::FILEIO_OFFSET_T, size_t>> mFiles;
+
+	mutable std::mutex mGuard;
+
+	BYTE* slotData(size_t argSlot)
+	{
+		return mArena.data() + argSlot * BLOCK_SIZE;
+	}
+
+	void releaseSlot(size_t argSlot);
+
+public:
+	void init(CSELIB::FILESIZE_T argCapacity);
+
+	bool enabled() const
+	{
+		return !mBlocks.empty();
+	}
+
+	bool get(const std::wstring& argWinPath, const std::wstring& argVersion, CSELIB::FILEIO_OFFSET_T argOffset, ULONG argLength, PVOID argBuffer);
+	void put(const std::wstring& argWinPath, const std::wstring& argVersion, CSELIB::FILEIO_OFFSET_T argBlockIndex, const BYTE* argData, ULONG argLength);
+	void invalidate(const std::wstring& argWinPath);
+
+	std::wstring str() const;
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
@@ -24,6 +24,1014 @@ ICSDriver* NewCSDriver(PCWSTR argCSDeviceType, PCWSTR argIniSection, NamedWorker
 
 namespace CSEDRV {
 
+// LbVt@C̍vTCŶ̊𒴂폜JnA
+// ̊ɂȂ܂ŌÂ̂폜
+
+static const int CACHE_HIGH_WATERMARK_PCT = 90;
+static const int CACHE_LOW_WATERMARK_PCT = 80;
+
+struct EvictCacheTask : public IOnDemandTask
+{
+	CSDriver* mThat;
+
+	EvictCacheTask(CSDriver* argThat)
+		:
+		mThat(argThat)
+	{
+	}
+
+	void run(int) override
+	{
+		mThat->evictCacheFiles(START_CALLER0);
+	}
+};
+
+NTSTATUS CSDriver::OnSvcStart(PCWSTR argWorkDir, FSP_FILE_SYSTEM* FileSystem)
+{
+	NEW_LOG_BLOCK();
+
+	const auto ntstatus = CSDriverBase::OnSvcStart(argWorkDir, FileSystem);
+	if (!NT_SUCCESS(ntstatus))
+	{
+		errorW(L"fault: OnSvcStart");
+		return ntstatus;
+	}
+
+	mFileSystem = FileSystem;
+
+	// O܂ł̃LbVt@C̍𕜌
+	// --> sĂ̏Ԃ瓮ł̂ŁAG[ɂ͂Ȃ
+
+	if (!mCacheIndex.open(mRuntimeEnv->CacheDataDir))
+	{
+		errorW(L"fault: mCacheIndex.open CacheDataDir=%s", mRuntimeEnv->CacheDataDir.c_str());
+	}
+
+	traceW(L"mCacheIndex.size=%zu", mCacheIndex.size());
+
+	if (!mRuntimeEnv->ColdCacheDir.empty())
+	{
+		if (!mColdCacheIndex.open(mRuntimeEnv->ColdCacheDir))
+		{
+			errorW(L"fault: mColdCacheIndex.open ColdCacheDir=%s", mRuntimeEnv->ColdCacheDir.c_str());
+		}
+
+		traceW(L"mColdCacheIndex.size=%zu", mColdCacheIndex.size());
+	}
+
+	// O̒~܂łɃAbv[hłȂt@C𕜌A𑗂
+
+	if (!mWriteBack.open(mRuntimeEnv->CacheDataDir))
+	{
+		errorW(L"fault: mWriteBack.open CacheDataDir=%s", mRuntimeEnv->CacheDataDir.c_str());
+	}
+
+	traceW(L"mWriteBack.size=%zu", mWriteBack.size());
+
+	mWriteBack.start(TIMEMILLIS_1SECull * mRuntimeEnv->WriteBackDelaySec, [this](const std::wstring& argWinPath)
+	{
+		this->flushWriteBack(START_CALLER argWinPath);
+	});
+
+	// ̃ubNELbV̗̈m
+
+	mBlockCache.init(static_cast<FILESIZE_T>(mRuntimeEnv->MemoryCacheSizeMib) * FILESIZE_1MiBll);
+
+	traceW(L"mBlockCache=%s", mBlockCache.str().c_str());
+
+	// ŜLbVꂽt@C}bv
+
+	mMappedViews.init(static_cast<FILESIZE_T>(mRuntimeEnv->MappedViewSizeMib) * FILESIZE_1MiBll);
+
+	traceW(L"mMappedViews=%s", mMappedViews.str().c_str());
+
+	// p[gTCY transfer_read_size_mib n߂āA]̌ʂŒ
+
+	mReadTuner.init(mRuntimeEnv->TransferAutoTune,
+		FILESIZE_1MiBll * mRuntimeEnv->TransferReadSizeMib,
+		FILESIZE_1MiBll * mRuntimeEnv->TransferMinSizeMib,
+		FILESIZE_1MiBll * mRuntimeEnv->TransferMaxSizeMib,
+		mRuntimeEnv->TransferMaxParallel);
+
+	traceW(L"mReadTuner=%s", mReadTuner.str().c_str());
+
+	// O̒~eʂ̏ȂĂ邩Ȃ
+
+	this->scheduleEviction(mCacheIndex.totalBytes());
+
+	return STATUS_SUCCESS;
+}
+
+VOID CSDriver::OnSvcStop()
+{
+	// Abv[h҂̂̂͑ҋ@Ԃ҂ɑ
+	// --> ŝ̓W[iɎĉŁA̋Nɑ
+
+	mWriteBack.stop();
+
+	for (const auto& winPath: mWriteBack.keys())
+	{
+		this->flushWriteBack(START_CALLER winPath);
+	}
+
+	CSDriverBase::OnSvcStop();
+
+	mCacheIndex.close();
+	mColdCacheIndex.close();
+}
+
+void CSDriver::onIdle()
+{
+	NEW_LOG_BLOCK();
+
+	if (!mCacheSwept.exchange(true))
+	{
+		// ɋL^ĂȂLbVt@Ĉ߂ɁANɈx
+		// fBNg𑖍Bȍ~͍݂̂ō폜
+
+		CSDriverBase::onIdle();
+
+		const auto numPruned = mCacheIndex.prune();
+
+		traceW(L"numPruned=%zu", numPruned);
+
+		if (!mRuntimeEnv->ColdCacheDir.empty())
+		{
+			const auto numColdPruned = mColdCacheIndex.prune();
+
+			traceW(L"numColdPruned=%zu", numColdPruned);
+		}
+	}
+
+	this->evictCacheFiles(START_CALLER0);
+}
+
+void CSDriver::scheduleEviction(FILESIZE_T argTotalBytes)
+{
+	const auto maxBytes = static_cast<FILESIZE_T>(mRuntimeEnv->MaxCacheSizeGiB) * FILESIZE_1GiBll;
+
+	if (maxBytes <= 0 || argTotalBytes <= maxBytes / 100 * CACHE_HIGH_WATERMARK_PCT)
+	{
+		return;
+	}
+
+	// ɓo^ς̂Ƃ͕sv
+
+	if (!mEvictQueued.exchange(true))
+	{
+		this->getWorker(L"delayed")->addTask(new EvictCacheTask{ this });
+	}
+}
+
+void CSDriver::evictCacheFiles(CALLER_ARG0)
+{
+	NEW_LOG_BLOCK();
+
+	std::lock_guard<std::mutex> lock_{ mEvictGuard };
+
+	mEvictQueued = false;
+
+	// ŏIANZXێԂ߂
+
+	const auto nowMillis = GetCurrentUtcMillis();
+	const auto retentionMillis = TIMEMILLIS_1MINull * mRuntimeEnv->CacheFileRetentionMin;
+	const auto expireMillis = nowMillis > retentionMillis ? nowMillis - retentionMillis : 0ULL;
+
+	// vTCYʂ𒴂ĂƂ͒ᐅʂ܂
+
+	const auto maxBytes = static_cast<FILESIZE_T>(mRuntimeEnv->MaxCacheSizeGiB) * FILESIZE_1GiBll;
+	const auto totalBytes = mCacheIndex.totalBytes();
+
+	auto targetBytes = -1LL;
+
+	if (maxBytes > 0 && totalBytes > maxBytes / 100 * CACHE_HIGH_WATERMARK_PCT)
+	{
+		targetBytes = maxBytes / 100 * CACHE_LOW_WATERMARK_PCT;
+	}
+
+	traceW(L"totalBytes=%lld targetBytes=%lld expireMillis=%llu", totalBytes, targetBytes, expireMillis);
+
+	// ÂɎ擾AI[vȂǂō폜łȂ͔̂΂
+
+	size_t numSkipped = 0;
+	size_t numEvicted = 0;
+	size_t numDemoted = 0;
+	bool done = false;
+
+	while (!done)
+	{
+		const auto entries{ mCacheIndex.oldest(numSkipped, 64) };
+		if (entries.empty())
+		{
+			break;
+		}
+
+		for (const auto& [winPath, entry]: entries)
+		{
+			const bool expired = entry.mLastAccessMillis < expireMillis;
+			const bool overBudget = targetBytes >= 0 && mCacheIndex.totalBytes() > targetBytes;
+
+			if (!expired && !overBudget)
+			{
+				// ȍ~͐V̂Ȃ
+
+				done = true;
+				break;
+			}
+
+			// I[v⏑݂ƋȂ悤ɁAt@CŔr䂷
+
+			UnprotectedShare<FileNameGuard> unsafeShare{ &mFileNameGuard, winPath };
+			{
+				const auto safeShare{ unsafeShare.lock() };
+
+				// 擾ĂςĂ邩Ȃ̂ŁA蒼
+
+				CacheIndex::Entry current;
+
+				if (!mCacheIndex.get(winPath, &current) || current.mCacheFilePath != entry.mCacheFilePath)
+				{
+					traceW(L"changed winPath=%s", winPath.c_str());
+
+					numSkipped++;
+					continue;
+				}
+
+				if (mOpenDirEntry.get(winPath))
+				{
+					traceW(L"opened winPath=%s", winPath.c_str());
+
+					numSkipped++;
+					continue;
+				}
+
+				if (mWriteBack.contains(winPath))
+				{
+					// Abv[hI܂ł͗B̓e
+
+					traceW(L"write back winPath=%s", winPath.c_str());
+
+					numSkipped++;
+					continue;
+				}
+
+				{
+					// ǂݒ̂̂폜Ȃ
+
+					std::lock_guard<std::mutex> prefetchLock_{ mPrefetchGuard };
+
+					if (mPrefetchQueued.find(winPath) != mPrefetchQueued.cend())
+					{
+						traceW(L"prefetching winPath=%s", winPath.c_str());
+
+						numSkipped++;
+						continue;
+					}
+				}
+
+				// }bv܂܂ł̓LbVt@C폜łȂ
+
+				mMappedViews.invalidate(winPath);
+
+				if (this->demoteCacheFile(CONT_CALLER winPath, current))
+				{
+					// ʂ̊KwɈڂ
+
+					numDemoted++;
+				}
+				else if (!::DeleteFilePassively(current.mCacheFilePath))
+				{
+					const auto lerr = ::GetLastError();
+
+					if (lerr != ERROR_FILE_NOT_FOUND && lerr != ERROR_PATH_NOT_FOUND)
+					{
+						traceW(L"warn: DeleteFilePassively lerr=%lu mCacheFilePath=%s", lerr, current.mCacheFilePath.c_str());
+
+						numSkipped++;
+						continue;
+					}
+				}
+
+				traceW(L"evict winPath=%s mPresentBytes=%lld", winPath.c_str(), current.mPresentBytes);
+
+				this->releaseSharedCacheFile(CONT_CALLER current);
+
+				mCacheIndex.remove(winPath, nullptr);
+				numEvicted++;
+			}
+		}
+	}
+
+	traceW(L"numEvicted=%zu numDemoted=%zu numSkipped=%zu totalBytes=%lld", numEvicted, numDemoted, numSkipped, mCacheIndex.totalBytes());
+
+	if (numDemoted > 0)
+	{
+		this->evictColdCacheFiles(CONT_CALLER0);
+	}
+}
+
+bool CSDriver::demoteCacheFile(CALLER_ARG const std::wstring& argWinPath, const CacheIndex::Entry& argEntry)
+{
+	NEW_LOG_BLOCK();
+
+	if (mRuntimeEnv->ColdCacheDir.empty())
+	{
+		return false;
+	}
+
+	// ETag ̂Ȃ ([Jō쐬) ́AɊJƂɓefłȂ
+
+	if (argEntry.mETag.empty())
+	{
+		return false;
+	}
+
+	// 擾ς̗ʂȂ̂́Aʂ̊KwɈڂ擾
+
+	if (argEntry.mPresentBytes < FILESIZE_1KiBll * mRuntimeEnv->ColdCacheAdmitMinKib)
+	{
+		traceW(L"not admitted mPresentBytes=%lld", argEntry.mPresentBytes);
+		return false;
+	}
+
+	std::filesystem::path coldCacheFilePath;
+
+	if (!resolveCacheFilePath(mRuntimeEnv->ColdCacheDir, argWinPath, argEntry.mETag, &coldCacheFilePath))
+	{
+		errorW(L"fault: resolveCacheFilePath argWinPath=%s", argWinPath.c_str());
+		return false;
+	}
+
+	// ʂ̃{[̂Ƃ̓Rs[ɂȂ (͈͏̑փf[^Xg[܂)
+
+	traceW(L"MoveFileExW mCacheFilePath=%s, coldCacheFilePath=%s", argEntry.mCacheFilePath.c_str(), coldCacheFilePath.c_str());
+
+	if (!::MoveFileExW(argEntry.mCacheFilePath.c_str(), coldCacheFilePath.c_str(), MOVEFILE_COPY_ALLOWED | MOVEFILE_REPLACE_EXISTING))
+	{
+		const auto lerr = ::GetLastError();
+
+		traceW(L"warn: MoveFileExW lerr=%lu mCacheFilePath=%s", lerr, argEntry.mCacheFilePath.c_str());
+		return false;
+	}
+
+	// ȑO̓ê̂cĂ΍폜
+
+	CacheIndex::Entry prevEntry;
+
+	if (mColdCacheIndex.get(argWinPath, &prevEntry) && prevEntry.mCacheFilePath != coldCacheFilePath)
+	{
+		if (!::DeleteFileW(prevEntry.mCacheFilePath.c_str()))
+		{
+			const auto lerr = ::GetLastError();
+			traceW(L"warn: DeleteFileW lerr=%lu", lerr);
+		}
+	}
+
+	mColdCacheIndex.set(argWinPath, coldCacheFilePath, argEntry.mETag, argEntry.mFileSize);
+	mColdCacheIndex.touch(argWinPath, argEntry.mPresentBytes);
+
+	traceW(L"demote argWinPath=%s mPresentBytes=%lld", argWinPath.c_str(), argEntry.mPresentBytes);
+
+	return true;
+}
+
+void CSDriver::promoteCacheFile(CALLER_ARG const std::wstring& argWinPath, const std::wstring& argETag, const std::filesystem::path& argCacheFilePath)
+{
+	NEW_LOG_BLOCK();
+
+	if (mRuntimeEnv->ColdCacheDir.empty())
+	{
+		return;
+	}
+
+	CacheIndex::Entry entry;
+
+	if (!mColdCacheIndex.get(argWinPath, &entry))
+	{
+		return;
+	}
+
+	if (entry.mETag != argETag || ::GetFileAttributesW(argCacheFilePath.c_str()) != INVALID_FILE_ATTRIBUTES)
+	{
+		// [gXVĂ邩ÅKwɐV̂
+
+		this->dropColdCacheFile(CONT_CALLER argWinPath);
+		return;
+	}
+
+	// ʂ̊Kw߂āÃLbVƂđ𗘗p
+
+	traceW(L"MoveFileExW mCacheFilePath=%s, argCacheFilePath=%s", entry.mCacheFilePath.c_str(), argCacheFilePath.c_str());
+
+	if (!::MoveFileExW(entry.mCacheFilePath.c_str(), argCacheFilePath.c_str(), MOVEFILE_COPY_ALLOWED))
+	{
+		const auto lerr = ::GetLastError();
+
+		traceW(L"warn: MoveFileExW lerr=%lu mCacheFilePath=%s", lerr, entry.mCacheFilePath.c_str());
+		return;
+	}
+
+	mColdCacheIndex.remove(argWinPath, nullptr);
+
+	mCacheIndex.set(argWinPath, argCacheFilePath, argETag, entry.mFileSize);
+	mCacheIndex.touch(argWinPath, entry.mPresentBytes);
+
+	traceW(L"promote argWinPath=%s mPresentBytes=%lld", argWinPath.c_str(), entry.mPresentBytes);
+
+	this->scheduleEviction(mCacheIndex.totalBytes());
+}
+
+void CSDriver::dropColdCacheFile(CALLER_ARG const std::wstring& argWinPath)
+{
+	NEW_LOG_BLOCK();
+
+	if (mRuntimeEnv->ColdCacheDir.empty())
+	{
+		return;
+	}
+
+	CacheIndex::Entry entry;
+
+	if (!mColdCacheIndex.remove(argWinPath, &entry))
+	{
+		return;
+	}
+
+	traceW(L"delete mCacheFilePath=%s", entry.mCacheFilePath.c_str());
+
+	if (!::DeleteFileW(entry.mCacheFilePath.c_str()))
+	{
+		const auto lerr = ::GetLastError();
+		traceW(L"warn: DeleteFileW lerr=%lu", lerr);
+	}
+}
+
+void CSDriver::evictColdCacheFiles(CALLER_ARG0)
+{
+	NEW_LOG_BLOCK();
+
+	// ʂ̊Kw͕ێԂł͍폜Aeʂ𒴂ƂɌÂ̂폜
+
+	const auto maxBytes = static_cast<FILESIZE_T>(mRuntimeEnv->ColdCacheSizeGiB) * FILESIZE_1GiBll;
+
+	if (mRuntimeEnv->ColdCacheDir.empty() || maxBytes <= 0 || mColdCacheIndex.totalBytes() <= maxBytes / 100 * CACHE_HIGH_WATERMARK_PCT)
+	{
+		return;
+	}
+
+	const auto targetBytes = maxBytes / 100 * CACHE_LOW_WATERMARK_PCT;
+
+	size_t numSkipped = 0;
+	size_t numEvicted = 0;
+
+	while (mColdCacheIndex.totalBytes() > targetBytes)
+	{
+		const auto entries{ mColdCacheIndex.oldest(numSkipped, 64) };
+		if (entries.empty())
+		{
+			break;
+		}
+
+		for (const auto& [winPath, entry]: entries)
+		{
+			if (mColdCacheIndex.totalBytes() <= targetBytes)
+			{
+				break;
+			}
+
+			if (!::DeleteFilePassively(entry.mCacheFilePath))
+			{
+				const auto lerr = ::GetLastError();
+
+				if (lerr != ERROR_FILE_NOT_FOUND && lerr != ERROR_PATH_NOT_FOUND)
+				{
+					traceW(L"warn: DeleteFilePassively lerr=%lu mCacheFilePath=%s", lerr, entry.mCacheFilePath.c_str());
+
+					numSkipped++;
+					continue;
+				}
+			}
+
+			mColdCacheIndex.remove(winPath, nullptr);
+			numEvicted++;
+		}
+	}
+
+	traceW(L"numEvicted=%zu numSkipped=%zu totalBytes=%lld", numEvicted, numSkipped, mColdCacheIndex.totalBytes());
+}
+
+static bool resolveSharedCacheFilePath(const std::filesystem::path& argDir, const std::wstring& argETag, FILESIZE_T argFileSize, std::filesystem::path* pPath)
+{
+	NEW_LOG_BLOCK();
+
+	// eŎʂ̂ŁApX͊܂߂ (ETag, TCY) 疼O쐬
+
+	std::wstring nameSha256;
+
+	const auto ntstatus = ComputeSHA256W(argETag + L'\n' + std::to_wstring(argFileSize), &nameSha256);
+	if (!NT_SUCCESS(ntstatus))
+	{
+		errorW(L"fault: ComputeSHA256W argETag=%s", argETag.c_str());
+		return false;
+	}
+
+	// 擪 2Byte ̓fBNg
+
+	auto filePath{ argDir / SafeSubStringW(nameSha256, 0, 2) };
+
+	std::error_code ec;
+	std::filesystem::create_directory(filePath, ec);
+
+	if (ec)
+	{
+		errorW(L"fault: create_directory filePath=%s", filePath.c_str());
+		return false;
+	}
+
+	filePath.append(SafeSubStringW(nameSha256, 2));
+
+	*pPath = std::move(filePath);
+
+	return true;
+}
+
+static bool getNumberOfLinks(const std::filesystem::path& argPath, DWORD* pNumberOfLinks)
+{
+	FileHandle file = ::CreateFileW(
+		argPath.c_str(),
+		FILE_READ_ATTRIBUTES,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+
+	if (file.invalid())
+	{
+		return false;
+	}
+
+	BY_HANDLE_FILE_INFORMATION info;
+
+	if (!::GetFileInformationByHandle(file.handle(), &info))
+	{
+		return false;
+	}
+
+	*pNumberOfLinks = info.nNumberOfLinks;
+
+	return true;
+}
+
+static bool copyFileAtomically(const std::filesystem::path& argSrc, const std::filesystem::path& argDst)
+{
+	// ̃CX^X珑ݓr̓eȂ悤ɁAĂ烊l[
+	// --> CopyFileW ͑փf[^Xg[ (͈͏) 
+
+	auto tmpPath{ argDst };
+	tmpPath += L".tmp" + std::to_wstring(::GetCurrentProcessId());
+
+	if (!::CopyFileW(argSrc.c_str(), tmpPath.c_str(), FALSE))
+	{
+		return false;
+	}
+
+	if (!::MoveFileExW(tmpPath.c_str(), argDst.c_str(), 0))
+	{
+		const auto lerr = ::GetLastError();
+
+		::DeleteFileW(tmpPath.c_str());
+		::SetLastError(lerr);
+
+		return false;
+	}
+
+	return true;
+}
+
+bool CSDriver::adoptSharedCacheFile(CALLER_ARG const std::wstring& argETag, FILESIZE_T argFileSize, const std::filesystem::path& argCacheFilePath)
+{
+	NEW_LOG_BLOCK();
+
+	if (mRuntimeEnv->SharedCacheDir.empty() || argETag.empty())
+	{
+		return false;
+	}
+
+	if (::GetFileAttributesW(argCacheFilePath.c_str()) != INVALID_FILE_ATTRIBUTES)
+	{
+		// ɃLbVt@C
+
+		return false;
+	}
+
+	std::filesystem::path sharedFilePath;
+
+	if (!resolveSharedCacheFilePath(mRuntimeEnv->SharedCacheDir, argETag, argFileSize, &sharedFilePath))
+	{
+		errorW(L"fault: resolveSharedCacheFilePath argETag=%s", argETag.c_str());
+		return false;
+	}
+
+	if (::GetFileAttributesW(sharedFilePath.c_str()) == INVALID_FILE_ATTRIBUTES)
+	{
+		return false;
+	}
+
+	// {[ł΃n[hENɂăfBXNL
+
+	if (!::CreateHardLinkW(argCacheFilePath.c_str(), sharedFilePath.c_str(), NULL))
+	{
+		const auto lerr = ::GetLastError();
+
+		traceW(L"CreateHardLinkW lerr=%lu, try copy", lerr);
+
+		if (!copyFileAtomically(sharedFilePath, argCacheFilePath))
+		{
+			const auto lerrCopy = ::GetLastError();
+
+			traceW(L"warn: copyFileAtomically lerr=%lu sharedFilePath=%s", lerrCopy, sharedFilePath.c_str());
+			return false;
+		}
+	}
+
+	traceW(L"adopt sharedFilePath=%s argCacheFilePath=%s", sharedFilePath.c_str(), argCacheFilePath.c_str());
+
+	return true;
+}
+
+void CSDriver::publishCacheFile(CALLER_ARG FileContext* ctx)
+{
+	NEW_LOG_BLOCK();
+
+	if (mRuntimeEnv->SharedCacheDir.empty() || (ctx->mFlags & FCTX_FLAGS_MODIFY))
+	{
+		return;
+	}
+
+	// Ŝ[gƈvĂ̂J
+
+	const auto& dirEntry{ ctx->getDirEntry() };
+	const auto etag{ getDirEntryETag(dirEntry) };
+	const auto fileSize = static_cast<FILESIZE_T>(dirEntry->mFileInfo.FileSize);
+
+	if (etag.empty() || fileSize <= 0)
+	{
+		return;
+	}
+
+	std::filesystem::path cacheFilePath;
+
+	if (!this->getCacheFilePath(ctx, &cacheFilePath))
+	{
+		return;
+	}
+
+	CacheExtents extents;
+
+	if (!this->loadCacheExtents(cacheFilePath, &extents) || extents.getETag() != etag || !extents.contains(0, fileSize))
+	{
+		return;
+	}
+
+	std::filesystem::path sharedFilePath;
+
+	if (!resolveSharedCacheFilePath(mRuntimeEnv->SharedCacheDir, etag, fileSize, &sharedFilePath))
+	{
+		errorW(L"fault: resolveSharedCacheFilePath etag=%s", etag.c_str());
+		return;
+	}
+
+	if (::GetFileAttributesW(sharedFilePath.c_str()) != INVALID_FILE_ATTRIBUTES)
+	{
+		// ̃CX^XJ
+
+		return;
+	}
+
+	// 쐬͌qIȂ̂ŁAɌJ悤ƂĂs邾
+
+	if (!::CreateHardLinkW(sharedFilePath.c_str(), cacheFilePath.c_str(), NULL))
+	{
+		const auto lerr = ::GetLastError();
+
+		traceW(L"CreateHardLinkW lerr=%lu, try copy", lerr);
+
+		if (!copyFileAtomically(cacheFilePath, sharedFilePath))
+		{
+			const auto lerrCopy = ::GetLastError();
+
+			traceW(L"warn: copyFileAtomically lerr=%lu cacheFilePath=%s", lerrCopy, cacheFilePath.c_str());
+			return;
+		}
+	}
+
+	traceW(L"publish cacheFilePath=%s sharedFilePath=%s", cacheFilePath.c_str(), sharedFilePath.c_str());
+}
+
+NTSTATUS CSDriver::unshareCacheFile(CALLER_ARG const std::filesystem::path& argWinPath, const std::filesystem::path& argCacheFilePath)
+{
+	NEW_LOG_BLOCK();
+
+	if (mRuntimeEnv->SharedCacheDir.empty())
+	{
+		return STATUS_SUCCESS;
+	}
+
+	DWORD numberOfLinks = 0;
+
+	if (!getNumberOfLinks(argCacheFilePath, &numberOfLinks) || numberOfLinks <= 1)
+	{
+		return STATUS_SUCCESS;
+	}
+
+	// LĂe͏Ȃ̂ŁA̕ɒu
+	// --> ̃nhLĂeJ܂܂̂Ƃ͒uȂ
+
+	if (mOpenDirEntry.get(argWinPath))
+	{
+		errorW(L"fault: shared and opened argWinPath=%s", argWinPath.c_str());
+		return STATUS_SHARING_VIOLATION;
+	}
+
+	mMappedViews.invalidate(argWinPath);
+
+	auto tmpPath{ argCacheFilePath };
+	tmpPath += L".unshare";
+
+	if (!::CopyFileW(argCacheFilePath.c_str(), tmpPath.c_str(), FALSE))
+	{
+		const auto lerr = ::GetLastError();
+
+		errorW(L"fault: CopyFileW lerr=%lu argCacheFilePath=%s", lerr, argCacheFilePath.c_str());
+		return FspNtStatusFromWin32(lerr);
+	}
+
+	if (!::MoveFileExW(tmpPath.c_str(), argCacheFilePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		const auto lerr = ::GetLastError();
+
+		errorW(L"fault: MoveFileExW lerr=%lu argCacheFilePath=%s", lerr, argCacheFilePath.c_str());
+
+		::DeleteFileW(tmpPath.c_str());
+
+		return FspNtStatusFromWin32(lerr);
+	}
+
+	traceW(L"unshare argCacheFilePath=%s", argCacheFilePath.c_str());
+
+	return STATUS_SUCCESS;
+}
+
+void CSDriver::releaseSharedCacheFile(CALLER_ARG const CacheIndex::Entry& argEntry)
+{
+	NEW_LOG_BLOCK();
+
+	if (mRuntimeEnv->SharedCacheDir.empty() || argEntry.mETag.empty())
+	{
+		return;
+	}
+
+	std::filesystem::path sharedFilePath;
+
+	if (!resolveSharedCacheFilePath(mRuntimeEnv->SharedCacheDir, argEntry.mETag, argEntry.mFileSize, &sharedFilePath))
+	{
+		return;
+	}
+
+	// ǂ̃CX^XNĂȂ΍폜
+
+	DWORD numberOfLinks = 0;
+
+	if (getNumberOfLinks(sharedFilePath, &numberOfLinks) && numberOfLinks == 1)
+	{
+		traceW(L"delete sharedFilePath=%s", sharedFilePath.c_str());
+
+		if (!::DeleteFilePassively(sharedFilePath))
+		{
+			const auto lerr = ::GetLastError();
+			traceW(L"warn: DeleteFilePassively lerr=%lu", lerr);
+		}
+	}
+}
+
+bool CSDriver::isCacheFilePinned(const std::filesystem::path& argCacheFilePath) const
+{
+	// Abv[h҂̃LbVt@C͕ێԂ߂Ăc
+
+	return mWriteBack.containsCacheFile(argCacheFilePath);
+}
+
+bool CSDriver::enqueueWriteBack(CALLER_ARG FileContext* ctx)
+{
+	NEW_LOG_BLOCK();
+
+	WriteBackQueue::Entry entry;
+
+	if (!this->getCacheFilePath(ctx, &entry.mCacheFilePath))
+	{
+		errorW(L"fault: getCacheFilePath ctx=%s", ctx->str().c_str());
+		return false;
+	}
+
+	// ύX͈͂̓Abv[h܂ňp
+
+	entry.mDirEntry = ctx->getDirEntry();
+	entry.mDirtyRanges = ctx->mDirtyRanges.snapshot();
+
+	traceW(L"enqueue ctx=%s", ctx->str().c_str());
+
+	mWriteBack.enqueue(ctx->getWinPath(), std::move(entry));
+
+	return true;
+}
+
+void CSDriver::flushWriteBack(CALLER_ARG const std::wstring& argWinPath)
+{
+	NEW_LOG_BLOCK();
+
+	// R[obNƓt@CŔr䂷
+	// --> Abv[h̊Ԃ͑̑҂Ȃ悤ɁAbN̓Gg̎擾
+	//     ʂ̔f̊Ԃێ
+
+	WriteBackQueue::Entry entry;
+	FileHandle file;
+
+	UnprotectedShare<FileNameGuard> unsafeShare{ &mFileNameGuard, argWinPath };
+	{
+		const auto safeShare{ unsafeShare.lock() };
+
+		if (mOpenDirEntry.get(argWinPath))
+		{
+			// ĂъJĂ̂ŁAN[YĂ瑗
+			// --> ύXꂸɃN[Y邱Ƃ̂ŁAGg͎cĂ
+
+			traceW(L"opened argWinPath=%s", argWinPath.c_str());
+
+			mWriteBack.reschedule(argWinPath, false);
+			return;
+		}
+
+		if (!this->openWriteBack(CONT_CALLER argWinPath, &entry, &file))
+		{
+			return;
+		}
+	}
+
+	// N[YƓ菇ő邽߂ɁAꎞIȃReNXg
+
+	OpenFileContext ctx{ argWinPath, entry.mDirEntry, std::move(file) };
+
+	if (entry.mDirtyRanges)
+	{
+		ctx.mDirtyRanges.restore(*entry.mDirtyRanges);
+	}
+
+	const bool uploaded = this->uploadContent(CONT_CALLER &ctx);
+
+	{
+		const auto safeShare{ unsafeShare.lock() };
+
+		WriteBackQueue::Entry current;
+
+		if (!mWriteBack.get(argWinPath, &current))
+		{
+			// Abv[hɍ폜ȂǂŎꂽ
+
+			traceW(L"not queued argWinPath=%s", argWinPath.c_str());
+			return;
+		}
+
+		if (current.mGeneration != entry.mGeneration)
+		{
+			// Abv[hɍĂѓo^ꂽ
+			// --> VGg̑ҋ@Ԃ̌ɉ߂đ
+
+			traceW(L"requeued argWinPath=%s", argWinPath.c_str());
+			return;
+		}
+
+		if (!uploaded)
+		{
+			errorW(L"fault: uploadContent argWinPath=%s", argWinPath.c_str());
+
+			mWriteBack.reschedule(argWinPath, true);
+			return;
+		}
+
+		if (mOpenDirEntry.get(argWinPath))
+		{
+			// Abv[hɊJꂽ̂́ALbVt@CtւȂ
+			// --> JĂnhŕύXĂ΁AN[YɍĂѓo^
+
+			traceW(L"opened argWinPath=%s", argWinPath.c_str());
+		}
+		else
+		{
+			this->updateCacheAfterUpload(CONT_CALLER &ctx);
+		}
+
+		mWriteBack.remove(argWinPath);
+	}
+
+	traceW(L"success: argWinPath=%s", argWinPath.c_str());
+}
+
+bool CSDriver::openWriteBack(CALLER_ARG const std::wstring& argWinPath, WriteBackQueue::Entry* pEntry, FileHandle* pFile)
+{
+	NEW_LOG_BLOCK();
+
+	// ĂяoŃt@C̔rsĂ邱
+
+	if (!mWriteBack.get(argWinPath, pEntry))
+	{
+		// 폜ȂǂŎꂽ
+
+		traceW(L"not queued argWinPath=%s", argWinPath.c_str());
+		return false;
+	}
+
+	const auto& entry{ *pEntry };
+
+	traceW(L"argWinPath=%s mCacheFilePath=%s", argWinPath.c_str(), entry.mCacheFilePath.c_str());
+
+	*pFile = ::CreateFileW(
+		entry.mCacheFilePath.c_str(),
+		GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+
+	if (pFile->invalid())
+	{
+		const auto lerr = ::GetLastError();
+
+		errorW(L"fault: CreateFileW lerr=%lu mCacheFilePath=%s", lerr, entry.mCacheFilePath.c_str());
+
+		if (lerr == ERROR_FILE_NOT_FOUND || lerr == ERROR_PATH_NOT_FOUND)
+		{
+			// eĂ̂ŁAĎsĂȂ
+
+			mWriteBack.remove(argWinPath);
+		}
+		else
+		{
+			mWriteBack.reschedule(argWinPath, true);
+		}
+
+		return false;
+	}
+
+	return true;
+}
+
+bool CSDriver::uploadWriteBack(CALLER_ARG const std::wstring& argWinPath)
+{
+	NEW_LOG_BLOCK();
+
+	// ĂяoŃt@C̔rsĂ邱
+
+	if (!mWriteBack.contains(argWinPath))
+	{
+		// 폜ȂǂŎꂽ
+
+		traceW(L"not queued argWinPath=%s", argWinPath.c_str());
+		return true;
+	}
+
+	WriteBackQueue::Entry entry;
+	FileHandle file;
+
+	if (!this->openWriteBack(CONT_CALLER argWinPath, &entry, &file))
+	{
+		errorW(L"fault: openWriteBack argWinPath=%s", argWinPath.c_str());
+		return false;
+	}
+
+	// N[YƓ菇ő邽߂ɁAꎞIȃReNXg
+
+	OpenFileContext ctx{ argWinPath, entry.mDirEntry, std::move(file) };
+
+	if (entry.mDirtyRanges)
+	{
+		ctx.mDirtyRanges.restore(*entry.mDirtyRanges);
+	}
+
+	if (!this->UploadWhenClosing(CONT_CALLER &ctx))
+	{
+		mWriteBack.reschedule(argWinPath, true);
+		return false;
+	}
+
+	mWriteBack.remove(argWinPath);
+
+	traceW(L"success: argWinPath=%s", argWinPath.c_str());
+
+	return true;
+}
+
 DirEntryType CSDriver::getDirEntryByWinPath(CALLER_ARG const std::filesystem::path& argWinPath) const
 {
 	if (argWinPath == L"\\")
@@ -65,6 +1073,15 @@ DirEntryType CSDriver::getDirEntryByWinPath(CALLER_ARG const std::filesystem::pa
 		{
 			// "\bucket\***" ̃p^[
 
+			// Abv[h҂̂̂̓[g胍[J̏ԂD
+
+			WriteBackQueue::Entry entry;
+
+			if (mWriteBack.get(argWinPath, &entry))
+			{
+				return entry.mDirEntry;
+			}
+
 			// Õt@CƃfBNg݂ƂɁAfBNgD悷邽
 			// ̖OfBNgɕϊXg[W𒲂ׁA݂ȂƂ̓t@CƂĒׂ
 
@@ -107,7 +1124,7 @@ NTSTATUS CSDriver::canCreateObject(CALLER_ARG const std::filesystem::path& argWi
 	// ύX̖OΏۂǂmF
 
 	const auto dirEntry{ mOpenDirEntry.get(argWinPath) };
-	if (dirEntry)
+	if (dirEntry || mWriteBack.contains(argWinPath))
 	{
 		traceW(L"already exist: argWinPath=%s", argWinPath.c_str());
 
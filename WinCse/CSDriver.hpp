@@ -2,30 +2,137 @@
 
 #include "CSDriverBase.hpp"
 #include "OpenDirEntry.hpp"
+#include "CacheExtents.hpp"
+#include "InflightParts.hpp"
+#include "CacheIndex.hpp"
+#include "BlockCache.hpp"
+#include "MappedViews.hpp"
+#include "WriteBackQueue.hpp"
 
 CSELIB::ICSDriver* NewCSDriver(PCWSTR argCSDeviceType, PCWSTR argIniSection, CSELIB::NamedWorker argWorkers[], CSELIB::ICSDevice* argCSDevice, WINCSE_DRIVER_STATS* argStats);
 
 namespace CSEDRV
 {
 
-bool resolveCacheFilePath(const std::filesystem::path& argDir, const std::wstring& argWinPath, std::filesystem::path* pPath);
+struct PendingRead;
+
+std::wstring getDirEntryETag(const CSELIB::DirEntryType& argDirEntry);
+std::wstring getContentVersion(const CSELIB::DirEntryType& argDirEntry);
+bool resolveCacheFilePath(const std::filesystem::path& argDir, const std::wstring& argWinPath, const std::wstring& argETag, std::filesystem::path* pPath);
 NTSTATUS syncAttributes(const CSELIB::DirEntryType& remoteDirEntry, const std::filesystem::path& cacheFilePath);
 
 class CSDriver final : public CSDriverBase
 {
 private:
 	OpenDirEntry mOpenDirEntry;
+	InflightParts mInflightParts;
+	CacheIndex mCacheIndex;
+
+	// ̃LbVǂoLbVt@Cێ鉺ʂ̊Kw
+
+	CacheIndex mColdCacheIndex;
+
+	BlockCache mBlockCache;
+	MappedViews mMappedViews;
+
+	// [g̎擾̃p[gTCYƓs
+
+	CSELIB::TransferTuner mReadTuner;
+
+	// ۗ Read ̉𑗐M
+
+	FSP_FILE_SYSTEM* mFileSystem = nullptr;
+
+	// LbVt@C͈̔͏̓ǂݏr
+
+	std::mutex mCacheExtentsGuard;
+
+	// ͈͏̏kLbVt@C̃l[Ői߂鐢
+	// --> FileContext ێLbVt@C̏Ԃ𖳌ɂ
+
+	std::atomic<UINT64> mCacheStateEpoch = 1ULL;
+
+	// p[g̎擾ɂ (ړ)
+
+	std::atomic<CSELIB::UTC_MILLIS_T> mFetchMillis = 0ULL;
+
+	// LbVt@C̍폜
+
+	std::mutex mEvictGuard;
+	std::atomic<bool> mEvictQueued = false;
+	std::atomic<bool> mCacheSwept = false;
+
+	// ꗗ̎擾ɐǂ݂\񂵂t@C
+
+	std::mutex mPrefetchGuard;
+	std::set<std::wstring> mPrefetchQueued;
+
+	// ݂ƕsăAbv[hĂt@C
+	// --> ̃nhύXꂽƂɒf
+
+	std::mutex mStreamUploadGuard;
+	std::map<std::wstring, std::weak_ptr<StreamUpload>> mStreamUploads;
+
+	// N[YɃAbv[h҂Ăt@C
+	// --> Xbh瑼̃oQƂ̂ŁAŏɔj悤ɍŌɒu
+
+	WriteBackQueue mWriteBack;
 
 private:
 	using CSDriverBase::CSDriverBase;
 
 	CSELIB::DirEntryType getDirEntryByWinPath(CALLER_ARG const std::filesystem::path& argWinPath) const;
 	NTSTATUS canCreateObject(CALLER_ARG const std::filesystem::path& argWinPath, bool argIsDir, std::optional<CSELIB::ObjectKey>* pOptObjKey);
-	NTSTATUS syncContent(CALLER_ARG FileContext* ctx, CSELIB::FILEIO_OFFSET_T argReadOffset, CSELIB::FILEIO_LENGTH_T argReadLength);
+	NTSTATUS syncContent(CALLER_ARG FileContext* ctx, CSELIB::FILEIO_OFFSET_T argReadOffset, CSELIB::FILEIO_LENGTH_T argReadLength, bool* pDownloaded, std::list<std::shared_ptr<ReadFilePartType>>* pPendingParts = nullptr);
+	NTSTATUS readCacheFile(CALLER_ARG FileContext* ctx, PVOID argBuffer, CSELIB::FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred);
+	NTSTATUS pendRead(CALLER_ARG FileContext* ctx, PVOID argBuffer, CSELIB::FILEIO_OFFSET_T argOffset, ULONG argLength, const std::list<std::shared_ptr<ReadFilePartType>>& argParts, PULONG argBytesTransferred);
+	void completePendingRead(CALLER_ARG const std::shared_ptr<PendingRead>& argPending);
+	bool readWithMappedView(CALLER_ARG FileContext* ctx, PVOID argBuffer, CSELIB::FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred);
+	NTSTATUS readWithBlockCache(CALLER_ARG FileContext* ctx, PVOID argBuffer, CSELIB::FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred, bool* pDownloaded, std::list<std::shared_ptr<ReadFilePartType>>* pPendingParts);
+	void readAhead(CALLER_ARG FileContext* ctx, CSELIB::FILEIO_OFFSET_T argReadOffset, CSELIB::FILEIO_LENGTH_T argReadLength, bool argDownloaded);
+	void prefetchHeadTail(CALLER_ARG FileContext* ctx);
+	bool canStreamRead(FileContext* ctx, CSELIB::FILEIO_OFFSET_T argOffset);
+	NTSTATUS readWithStream(CALLER_ARG FileContext* ctx, PVOID argBuffer, CSELIB::FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred);
+	void addStreamFilePartTask(const CSELIB::ObjectKey& argObjKey, const std::wstring& argETag, const std::shared_ptr<StreamFilePart>& argFilePart);
+	void addReadFilePartTask(const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart);
+	NTSTATUS waitInflightParts(CALLER_ARG FileContext* ctx, CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength);
+	NTSTATUS cancelInflightParts(CALLER_ARG FileContext* ctx);
 	NTSTATUS updateFileInfo(CALLER_ARG FileContext* ctx, FSP_FSCTL_FILE_INFO* pFileInfo, bool argRemoteSizeAware);
-	void UploadWhenClosing(CALLER_ARG  FileContext* ctx);
+	bool getCacheFilePath(FileContext* ctx, std::filesystem::path* pPath);
+	bool loadCacheExtents(const std::filesystem::path& argCacheFilePath, CacheExtents* pExtents);
+	NTSTATUS updateCacheExtents(CALLER_ARG const std::filesystem::path& argCacheFilePath, const std::function<void(CacheExtents*)>& callback);
+	NTSTATUS updateCacheExtents(CALLER_ARG FileContext* ctx, const std::function<void(CacheExtents*)>& callback);
+	bool UploadWhenClosing(CALLER_ARG  FileContext* ctx);
+	bool uploadContent(CALLER_ARG FileContext* ctx);
+	void updateCacheAfterUpload(CALLER_ARG FileContext* ctx);
+	bool enqueueWriteBack(CALLER_ARG FileContext* ctx);
+	bool openWriteBack(CALLER_ARG const std::wstring& argWinPath, WriteBackQueue::Entry* pEntry, CSELIB::FileHandle* pFile);
+	bool uploadWriteBack(CALLER_ARG const std::wstring& argWinPath);
+	void flushWriteBack(CALLER_ARG const std::wstring& argWinPath);
+	bool putObjectPartial(CALLER_ARG FileContext* ctx, const std::filesystem::path& argCacheFilePath);
+	void beginStreamUpload(CALLER_ARG FileContext* ctx);
+	void cancelOtherStreamUpload(CALLER_ARG FileContext* ctx);
+	void endStreamUpload(CALLER_ARG FileContext* ctx);
+	bool completeStreamUpload(CALLER_ARG FileContext* ctx);
+	bool rebindCacheFile(CALLER_ARG FileContext* ctx, const std::wstring& argETag, std::filesystem::path* pNewCacheFilePath);
+	void scheduleEviction(CSELIB::FILESIZE_T argTotalBytes);
+	bool demoteCacheFile(CALLER_ARG const std::wstring& argWinPath, const CacheIndex::Entry& argEntry);
+	void promoteCacheFile(CALLER_ARG const std::wstring& argWinPath, const std::wstring& argETag, const std::filesystem::path& argCacheFilePath);
+	void dropColdCacheFile(CALLER_ARG const std::wstring& argWinPath);
+	void evictColdCacheFiles(CALLER_ARG0);
+	bool adoptSharedCacheFile(CALLER_ARG const std::wstring& argETag, CSELIB::FILESIZE_T argFileSize, const std::filesystem::path& argCacheFilePath);
+	void publishCacheFile(CALLER_ARG FileContext* ctx);
+	NTSTATUS unshareCacheFile(CALLER_ARG const std::filesystem::path& argWinPath, const std::filesystem::path& argCacheFilePath);
+	void releaseSharedCacheFile(CALLER_ARG const CacheIndex::Entry& argEntry);
+	void registerCacheFile(CALLER_ARG const std::filesystem::path& argWinPath, const std::filesystem::path& argCacheFilePath, const std::wstring& argETag, CSELIB::FILESIZE_T argFileSize);
+	void prefetchSmallFiles(CALLER_ARG const std::list<std::pair<std::filesystem::path, CSELIB::DirEntryType>>& argCandidates);
 
 protected:
+	NTSTATUS OnSvcStart(PCWSTR argWorkDir, FSP_FILE_SYSTEM* FileSystem) override;
+	VOID     OnSvcStop() override;
+
+	bool isCacheFilePinned(const std::filesystem::path& argCacheFilePath) const override;
+
 	// CSDriverBase oRČĂяo֐
 
 	NTSTATUS GetSecurityByName(const std::filesystem::path& argWinPath, PUINT32 pFileAttributes, PSECURITY_DESCRIPTOR argSecurityDescriptor, PSIZE_T argSecurityDescriptorSize) override;
@@ -46,6 +153,19 @@ protected:
 	NTSTATUS Write(FileContext* ctx, PVOID argBuffer, UINT64 argOffset, ULONG argLength, BOOLEAN argWriteToEndOfFile, BOOLEAN argConstrainedIo, PULONG argBytesTransferred, FSP_FSCTL_FILE_INFO* pFileInfo) override;
 	NTSTATUS SetDelete(FileContext* ctx, PCWSTR argFileName, BOOLEAN argDeleteFile) override;
 
+public:
+	void onIdle() override;
+
+	// ReadFilePartTask, StreamFilePartTask, PrefetchFileTask, EvictCacheTask Ăяo֐
+
+	void evictCacheFiles(CALLER_ARG0);
+
+	CSELIB::FILEIO_LENGTH_T readFilePart(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart);
+	void completeFilePart(const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart, CSELIB::FILEIO_LENGTH_T argResult);
+	CSELIB::FILEIO_LENGTH_T streamFilePart(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::wstring& argETag, const std::shared_ptr<StreamFilePart>& argFilePart);
+	void prefetchFile(CALLER_ARG const std::filesystem::path& argWinPath);
+	void endPrefetch(const std::filesystem::path& argWinPath);
+
 private:
 	friend CSELIB::ICSDriver* ::NewCSDriver(PCWSTR argCSDeviceType, PCWSTR argIniSection, CSELIB::NamedWorker argWorkers[], CSELIB::ICSDevice* argCSDevice, WINCSE_DRIVER_STATS* argStats);
 };
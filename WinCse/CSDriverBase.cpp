@@ -170,6 +170,39 @@ NTSTATUS CSDriverBase::OnSvcStart(PCWSTR argWorkDir, FSP_FILE_SYSTEM* FileSystem
 		return STATUS_INSUFFICIENT_RESOURCES;
 	}
 
+	// ̃LbVǂot@Cێ鉺ʂ̊Kw (C)
+	// --> eʂ̑傫Ȓᑬ̃fBXNw肷
+
+	std::filesystem::path coldCacheDir;
+	std::wstring coldCacheDirStr;
+
+	if (GetIniStringW(confPath, mIniSection, L"cold_cache_dir", &coldCacheDirStr) && !coldCacheDirStr.empty())
+	{
+		coldCacheDir = std::filesystem::path{ coldCacheDirStr } / mDeviceType / CACHE_DATA_DIR_FNAME;
+
+		if (!mkdirIfNotExists(coldCacheDir))
+		{
+			errorW(L"fault: mkdirIfNotExists coldCacheDir=%s", coldCacheDir.c_str());
+			return STATUS_INSUFFICIENT_RESOURCES;
+		}
+	}
+
+	// ̃CX^XœẽLbVt@CLfBNg (C)
+
+	std::filesystem::path sharedCacheDir;
+	std::wstring sharedCacheDirStr;
+
+	if (GetIniStringW(confPath, mIniSection, L"shared_cache_dir", &sharedCacheDirStr) && !sharedCacheDirStr.empty())
+	{
+		sharedCacheDir = sharedCacheDirStr;
+
+		if (!mkdirIfNotExists(sharedCacheDir))
+		{
+			errorW(L"fault: mkdirIfNotExists sharedCacheDir=%s", sharedCacheDir.c_str());
+			return STATUS_INSUFFICIENT_RESOURCES;
+		}
+	}
+
 	const auto cacheReportDir{ workDir / mDeviceType / CACHE_REPORT_DIR_FNAME };
 	if (!mkdirIfNotExists(cacheReportDir))
 	{
@@ -195,17 +228,37 @@ NTSTATUS CSDriverBase::OnSvcStart(PCWSTR argWorkDir, FSP_FILE_SYSTEM* FileSystem
 	auto runtimeEnv = std::make_unique<RuntimeEnv>(
 		//         ini-path     section         key                             default   min         max
 		//----------------------------------------------------------------------------------------------------
+		GetIniBoolW(confPath,	mIniSection,	L"async_read",					 true),
 		cacheDataDir,
 		GetIniIntW(confPath,    mIniSection,    L"cache_file_retention_min",        60,		1,	   10080),
 		cacheReportDir,
+		GetIniIntW(confPath,	mIniSection,	L"cold_cache_admit_min_kib",	  1024,		0,	 INT_MAX),
+		coldCacheDir,
+		GetIniIntW(confPath,	mIniSection,	L"cold_cache_size_gib",				 0,		0,	 INT_MAX),
 		STCTimeToWinFileTime100nsW(argWorkDir),
 		defaultFileAttributes,
 		GetIniIntW(confPath,    mIniSection,    L"delete_after_upload",              0,     0,         2),
 		GetIniIntW(confPath,    mIniSection,    L"delete_dir_condition",             2,		1,		   2),
 		std::move(dirSecRef),
 		std::move(fileSecRef),
+		GetIniIntW(confPath,	mIniSection,	L"head_tail_prefetch_kib",		   256,		0,	   16384),
+		GetIniIntW(confPath,	mIniSection,	L"mapped_view_size_mib",		  1024,		0,	 1048576),
+		GetIniIntW(confPath,	mIniSection,	L"max_cache_size_gib",				 0,		0,	 INT_MAX),
+		GetIniIntW(confPath,	mIniSection,	L"memory_cache_size_mib",			64,		0,	    4096),
+		GetIniIntW(confPath,	mIniSection,	L"prefetch_dir_budget_mib",			16,		1,	    1024),
+		GetIniIntW(confPath,	mIniSection,	L"prefetch_file_max_size_kib",		 0,		0,	  102400),
+		GetIniIntW(confPath,	mIniSection,	L"read_ahead_max_parts",			 4,		0,		  32),
 		GetIniBoolW(confPath,	mIniSection,	L"readonly",					false),
-		GetIniIntW(confPath,	mIniSection,	L"transfer_read_size_mib",			10,		5,		 100)
+		sharedCacheDir,
+		GetIniIntW(confPath,	mIniSection,	L"stream_read_min_size_mib",	  1024,		0,	 INT_MAX),
+		GetIniIntW(confPath,	mIniSection,	L"stream_read_ring_parts",			 4,		1,		  32),
+		GetIniBoolW(confPath,	mIniSection,	L"stream_upload",				 true),
+		GetIniBoolW(confPath,	mIniSection,	L"transfer_auto_tune",			true),
+		GetIniIntW(confPath,	mIniSection,	L"transfer_max_parallel",			 8,		1,		  32),
+		GetIniIntW(confPath,	mIniSection,	L"transfer_max_size_mib",		   100,		5,		 100),
+		GetIniIntW(confPath,	mIniSection,	L"transfer_min_size_mib",			 5,		5,		 100),
+		GetIniIntW(confPath,	mIniSection,	L"transfer_read_size_mib",			10,		5,		 100),
+		GetIniIntW(confPath,	mIniSection,	L"write_back_delay_sec",			 5,		0,		3600)
 	);
 
 	traceW(L"runtimeEnv=%s", runtimeEnv->str().c_str());
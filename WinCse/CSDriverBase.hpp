@@ -41,8 +41,22 @@ protected:
 
 	void applyDefaultFileAttributes(FSP_FSCTL_FILE_INFO* pFileInfo) const;
 
+	// ێԂ߂Ă폜Ă͂ȂLbVt@C
+
+	virtual bool isCacheFilePinned(const std::filesystem::path&) const
+	{
+		return false;
+	}
+
+	// ɊJĂt@C̃LbVt@C
+
+	bool getOpenCacheFilePath(const std::filesystem::path& argWinPath, std::filesystem::path* pCacheFilePath) const
+	{
+		return mFileContextSweeper.getCacheFilePath(argWinPath, pCacheFilePath);
+	}
+
 public:
-	void onIdle();
+	virtual void onIdle();
 
 	std::list<std::wstring> getNotificationList() override
 	{
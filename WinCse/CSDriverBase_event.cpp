@@ -33,6 +33,20 @@ void CSDriverBase::onIdle()
     {
         NEW_LOG_BLOCK();
 
+        if (_wcsnicmp(wfd.cFileName, CACHE_INDEX_FNAME, wcslen(CACHE_INDEX_FNAME)) == 0)
+        {
+            // LbVt@C̍ (ꎞt@C܂) ͑ΏۊO
+
+            return;
+        }
+
+        if (_wcsnicmp(wfd.cFileName, WRITE_BACK_QUEUE_FNAME, wcslen(WRITE_BACK_QUEUE_FNAME)) == 0)
+        {
+            // Abv[h҂̋L^ (ꎞt@C܂) ΏۊO
+
+            return;
+        }
+
         const auto fileMillis = WinFileTimeToUtcMillis(wfd.ftLastAccessTime);
         const auto diffMillis = nowMillis - fileMillis;
 
@@ -43,6 +57,14 @@ void CSDriverBase::onIdle()
         {
             traceW(L"The cache file has expired.");
 
+            if (this->isCacheFilePinned(fullPath))
+            {
+                // Abv[hI܂ł͗B̓e
+
+                traceW(L"--> Pinned");
+                return;
+            }
+
             if (::DeleteFilePassively(fullPath.c_str()))
             {
                 traceW(L"--> Removed");
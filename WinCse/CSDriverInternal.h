@@ -5,6 +5,16 @@
 namespace CSEDRV
 {
 
+using ReadFilePartType = CSELIB::FilePart<CSELIB::FILEIO_LENGTH_T>;
+
+// LbVt@C̍L^W[i̖O (LbVEfBNg)
+
+constexpr const wchar_t* const CACHE_INDEX_FNAME = L"wincse-index.journal";
+
+// Abv[h҂̃t@CL^W[i̖O (LbVEfBNg)
+
+constexpr const wchar_t* const WRITE_BACK_QUEUE_FNAME = L"wincse-writeback.journal";
+
 }
 
 // EOF
\ No newline at end of file
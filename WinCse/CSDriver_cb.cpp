@@ -157,19 +157,62 @@ NTSTATUS CSDriver::Open(const std::filesystem::path& argWinPath, UINT32 argCreat
         {
             // LbVt@C̑(TCYȊO) [gƓ
 
+            const auto etag{ getDirEntryETag(dirEntry) };
+
             std::filesystem::path cacheFilePath;
 
-            if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, argWinPath, &cacheFilePath))
+            // Abv[h҂̂̂́ALbVt@CB̓eȂ̂œȂ
+
+            WriteBackQueue::Entry writeBack;
+
+            const bool isWriteBack = mWriteBack.get(argWinPath, &writeBack);
+
+            if (isWriteBack)
             {
-                errorW(L"fault: resolveCacheFilePath argWinPath=%s", argWinPath.c_str());
-                return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
+                traceW(L"write back argWinPath=%s", argWinPath.c_str());
+
+                cacheFilePath = writeBack.mCacheFilePath;
             }
+            else if (addRefCount && this->getOpenCacheFilePath(argWinPath, &cacheFilePath))
+            {
+                // ɊJĂ̂́Ãnh񂾓eȂ悤ɓȂ
 
-            const auto ntstatus = syncAttributes(dirEntry, cacheFilePath);
-            if (!NT_SUCCESS(ntstatus))
+                traceW(L"already opened cacheFilePath=%s", cacheFilePath.c_str());
+            }
+            else
             {
-                errorW(L"fault: syncRemoteAttributes dirEntry=%s", dirEntry->str().c_str());
-                return ntstatus;
+                if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, argWinPath, etag, &cacheFilePath))
+                {
+                    errorW(L"fault: resolveCacheFilePath argWinPath=%s", argWinPath.c_str());
+                    return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
+                }
+
+                // ʂ̊KwɂΎ̊Kwɖ߂
+
+                this->promoteCacheFile(START_CALLER argWinPath, etag, cacheFilePath);
+
+                // ̃CX^X擾ς̓e΋L
+
+                this->adoptSharedCacheFile(START_CALLER etag, dirEntry->mFileInfo.FileSize, cacheFilePath);
+
+                const auto ntstatus = syncAttributes(dirEntry, cacheFilePath);
+                if (!NT_SUCCESS(ntstatus))
+                {
+                    errorW(L"fault: syncRemoteAttributes dirEntry=%s", dirEntry->str().c_str());
+                    return ntstatus;
+                }
+            }
+
+            if (argGrantedAccess & (FILE_WRITE_DATA | FILE_APPEND_DATA))
+            {
+                // ̃CX^XƋLĂeɂ͏܂Ȃ
+
+                const auto ntstatusUnshare = this->unshareCacheFile(START_CALLER argWinPath, cacheFilePath);
+                if (!NT_SUCCESS(ntstatusUnshare))
+                {
+                    errorW(L"fault: unshareCacheFile argWinPath=%s", argWinPath.c_str());
+                    return ntstatusUnshare;
+                }
             }
 
             // LbVt@CJReNXgɕۑ
@@ -198,8 +241,40 @@ NTSTATUS CSDriver::Open(const std::filesystem::path& argWinPath, UINT32 argCreat
                 return FspNtStatusFromWin32(lerr);
             }
 
+            this->registerCacheFile(START_CALLER argWinPath, cacheFilePath, etag, dirEntry->mFileInfo.FileSize);
+
             ctx = std::make_unique<OpenFileContext>(argWinPath, dirEntry, std::move(file));
 
+            // ύX͈͂̋L^n߂
+            // --> ŊJĂƂ̓[gƓeƂ͌Ȃ̂ŁAŜAbv[h
+            // --> Abv[h҂̂̂́AN[YO܂ł̕ύXp
+
+            if (!addRefCount)
+            {
+                if (isWriteBack)
+                {
+                    if (writeBack.mDirtyRanges)
+                    {
+                        ctx->mDirtyRanges.restore(*writeBack.mDirtyRanges);
+                    }
+                }
+                else if (!etag.empty())
+                {
+                    ctx->mDirtyRanges.reset(dirEntry->mFileInfo.FileSize, etag);
+                }
+            }
+
+            // ɓǂނƂ錾Ă΁ALbVt@CoRȂ Read ̑Ώۂɂ
+
+            ctx->mStreamRead.setSequentialOnly(argCreateOptions & FILE_SEQUENTIAL_ONLY);
+
+            // ɖڎ`́Aŏ Read Oɐ擪ƖsĎ擾Ă
+
+            if ((argGrantedAccess & FILE_READ_DATA) && !(argCreateOptions & FILE_SEQUENTIAL_ONLY))
+            {
+                this->prefetchHeadTail(START_CALLER ctx.get());
+            }
+
             break;
         }
     }
@@ -308,9 +383,11 @@ NTSTATUS CSDriver::Create(const std::filesystem::path& argWinPath, UINT32 argCre
     {
         // LbVt@C̍쐬
 
+        // VK쐬Ȃ̂ ETag ݂͑Ȃ
+
         std::filesystem::path cacheFilePath;
 
-        if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, argWinPath, &cacheFilePath))
+        if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, argWinPath, L"", &cacheFilePath))
         {
             errorW(L"fault: resolveCacheFilePath argWinPath=%s", argWinPath.c_str());
             return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
@@ -345,7 +422,25 @@ NTSTATUS CSDriver::Create(const std::filesystem::path& argWinPath, UINT32 argCre
             return FspNtStatusFromWin32(::GetLastError());
         }
 
+        // VK쐬Ȃ̂ŁA[g擾͈݂͂͑Ȃ
+
+        if (!CacheExtents{}.save(cacheFilePath))
+        {
+            errorW(L"fault: save cacheFilePath=%s", cacheFilePath.c_str());
+            return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
+        }
+
+        mCacheIndex.set(argWinPath, cacheFilePath, L"", 0LL);
+
         ctx = std::make_unique<OpenFileContext>(argWinPath, dirEntry, std::move(file));
+
+        // ݂ƕsăAbv[hł悤ɂ
+        // --> N[Yɍ폜ꎞt@C͑ΏۊO
+
+        if (!(argCreateOptions & FILE_DELETE_ON_CLOSE))
+        {
+            this->beginStreamUpload(START_CALLER ctx.get());
+        }
     }
 
     traceW(L"ctx=%s", ctx->str().c_str());
@@ -366,12 +461,27 @@ NTSTATUS CSDriver::Create(const std::filesystem::path& argWinPath, UINT32 argCre
 	return STATUS_SUCCESS;
 }
 
-void CSDriver::UploadWhenClosing(CALLER_ARG FileContext* ctx)
+bool CSDriver::UploadWhenClosing(CALLER_ARG FileContext* ctx)
 {
     NEW_LOG_BLOCK();
 
     // eɕύXA[gւ̔fKvȏ
 
+    if (!this->uploadContent(CONT_CALLER ctx))
+    {
+        errorW(L"fault: uploadContent ctx=%s", ctx->str().c_str());
+        return false;
+    }
+
+    this->updateCacheAfterUpload(CONT_CALLER ctx);
+
+    return true;
+}
+
+bool CSDriver::uploadContent(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
     const auto& dirEntry{ ctx->getDirEntry() };
     const auto objKey{ ctx->getObjectKey() };
 
@@ -388,32 +498,92 @@ void CSDriver::UploadWhenClosing(CALLER_ARG FileContext* ctx)
             if (!GetFileNameFromHandle(ctx->getHandle(), &cacheFilePath))
             {
                 errorW(L"fault: GetFileNameFromHandle ctx=%s", ctx->str().c_str());
-                break;
+                return false;
             }
 
-            // _E[h擾
+            // ݂ƕsăAbv[hĂ΁Ac𑗂Ċ
+            // --> łȂΕύX͈͂𑗂AȊO̓[g̕ύXO̓eRs[
 
-            auto ntstatus = this->syncContent(CONT_CALLER ctx, 0, (FILEIO_LENGTH_T)dirEntry->mFileInfo.FileSize);
-            if (!NT_SUCCESS(ntstatus))
+            if (this->completeStreamUpload(CONT_CALLER ctx))
             {
-                errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
-                break;
+                traceW(L"success: completeStreamUpload objKey=%s", objKey.c_str());
             }
+            else if (this->putObjectPartial(CONT_CALLER ctx, cacheFilePath))
+            {
+                traceW(L"success: putObjectPartial objKey=%s", objKey.c_str());
+            }
+            else
+            {
+                // _E[h擾
+
+                auto ntstatus = this->syncContent(CONT_CALLER ctx, 0, (FILEIO_LENGTH_T)dirEntry->mFileInfo.FileSize, nullptr);
+                if (!NT_SUCCESS(ntstatus))
+                {
+                    errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
+                    return false;
+                }
 
-            // Abv[h̎s
+                // Abv[h̎s
 
-            if (!mDevice->putObject(START_CALLER objKey, dirEntry->mFileInfo, cacheFilePath.c_str()))
-            {
-                errorW(L"fault: putObject objKey=%s", objKey.c_str());
-                break;
+                if (!mDevice->putObject(START_CALLER objKey, dirEntry->mFileInfo, cacheFilePath.c_str()))
+                {
+                    errorW(L"fault: putObject objKey=%s", objKey.c_str());
+                    return false;
+                }
+
+                traceW(L"success: putObject objKey=%s", objKey.c_str());
             }
 
-            traceW(L"success: putObject objKey=%s", objKey.c_str());
+            break;
+        }
+    }
+
+    return true;
+}
+
+void CSDriver::updateCacheAfterUpload(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
+    const auto& dirEntry{ ctx->getDirEntry() };
+    const auto objKey{ ctx->getObjectKey() };
+
+    switch (dirEntry->mFileType)
+    {
+        case FileTypeEnum::File:
+        {
+            std::filesystem::path cacheFilePath;
+
+            if (!GetFileNameFromHandle(ctx->getHandle(), &cacheFilePath))
+            {
+                errorW(L"fault: GetFileNameFromHandle ctx=%s", ctx->str().c_str());
+                return;
+            }
 
             // LbV̍XV
             // robocopy ΍
 
-            mDevice->headObject(START_CALLER objKey, nullptr);
+            DirEntryType newDirEntry;
+
+            if (mDevice->headObject(START_CALLER objKey, &newDirEntry))
+            {
+                // Abv[hɂ ETag ς̂ŁALbVt@CVe̖Oɕtւ
+
+                std::filesystem::path newCacheFilePath;
+
+                if (this->rebindCacheFile(START_CALLER ctx, getDirEntryETag(newDirEntry), &newCacheFilePath))
+                {
+                    cacheFilePath = std::move(newCacheFilePath);
+                }
+                else
+                {
+                    errorW(L"fault: rebindCacheFile ctx=%s", ctx->str().c_str());
+                }
+            }
+            else
+            {
+                errorW(L"fault: headObject objKey=%s", objKey.c_str());
+            }
 
             switch (mRuntimeEnv->DeleteAfterUpload)
             {
@@ -421,6 +591,8 @@ void CSDriver::UploadWhenClosing(CALLER_ARG FileContext* ctx)
                 {
                     // Abv[hɃt@C폜
 
+                    mMappedViews.invalidate(ctx->getWinPath());
+
                     if (::DeleteFileW(cacheFilePath.c_str()))
                     {
                         traceW(L"success: DeleteFileW cacheFilePath=%s", cacheFilePath.c_str());
@@ -462,17 +634,74 @@ VOID CSDriver::Close(FileContext* ctx)
 
     traceW(L"ctx=%s", ctx->str().c_str());
 
+    // ǂݒ̃p[g𒆒fAŝ̂͊҂
+
+    ctx->mReadAhead.cancel();
+    ctx->mStreamRead.cancel();
+
     if (ctx->getHandle() == INVALID_HANDLE_VALUE)
     {
         // SetDelete ō폜tOACleanup ŕĂ
 
         traceW(L"already closed");
     }
-    else if (ctx->mFlags & FCTX_FLAGS_MODIFY)
+    else
     {
-        this->UploadWhenClosing(START_CALLER ctx);
+        if (ctx->mFlags & FCTX_FLAGS_MODIFY)
+        {
+            // Abv[h̓obNOEhőҋ@Ԃ̌ɍsAN[Y҂Ȃ
+            // --> o^łȂΏ]ʂ肱ő
+            // --> ݂ƕsăp[g𑗂n߂Ă̂́AŎc𑗂Ċ
+            //     ܂ĂȂΒfāAƓ悤ɑҋ@
+
+            const bool streaming = ctx->mStreamUpload && ctx->mStreamUpload->started();
+
+            if (!streaming && ctx->mStreamUpload)
+            {
+                ctx->mStreamUpload->cancel();
+            }
+
+            const bool writeBack = !streaming && mRuntimeEnv->WriteBackDelaySec > 0 &&
+                ctx->getDirEntry()->mFileType == FileTypeEnum::File &&
+                this->enqueueWriteBack(START_CALLER ctx);
+
+            if (!writeBack)
+            {
+                if (!this->UploadWhenClosing(START_CALLER ctx))
+                {
+                    errorW(L"fault: UploadWhenClosing ctx=%s", ctx->str().c_str());
+                }
+            }
+        }
+
+        if (ctx->getDirEntry()->mFileType == FileTypeEnum::File)
+        {
+            // ̍ŏIANZXƃfBXÑTCYXV
+            // --> Xp[XEt@CȂ̂ŁA蓖čς̃TCYg
+
+            FILE_STANDARD_INFO standardInfo;
+
+            if (::GetFileInformationByHandleEx(ctx->getHandle(), FileStandardInfo, &standardInfo, sizeof(standardInfo)))
+            {
+                if (mCacheIndex.touch(ctx->getWinPath(), standardInfo.AllocationSize.QuadPart))
+                {
+                    this->scheduleEviction(mCacheIndex.totalBytes());
+                }
+
+                if (standardInfo.NumberOfLinks == 1)
+                {
+                    // Ŝ擾ςł΁ÃCX^XƋL
+
+                    this->publishCacheFile(START_CALLER ctx);
+                }
+            }
+        }
     }
 
+    // ĂȂ݂ƕsAbv[h͒f
+
+    this->endStreamUpload(START_CALLER ctx);
+
     // I[v̏񂩂폜
 
     const bool b = mOpenDirEntry.release(ctx->getWinPath());
@@ -493,6 +722,10 @@ VOID CSDriver::Cleanup(FileContext* ctx, PCWSTR argWinPath, ULONG argFlags)
 
     traceW(L"argWinPath=%s argFlags=%lu ctx=%s", argWinPath, argFlags, ctx->str().c_str());
 
+    // nhꂽ̂ŁAobNOEhŎ擾̃p[g͒f
+
+    ctx->mReadAhead.cancel();
+
     if (argFlags & FspCleanupDelete)
     {
         const auto& refWinPath{ ctx->getWinPath() };
@@ -511,8 +744,14 @@ VOID CSDriver::Cleanup(FileContext* ctx, PCWSTR argWinPath, ULONG argFlags)
 
             case FileTypeEnum::File:
             {
+                // _E[h̃p[gLbVt@CJ܂܂ɂȂȂ悤
+
+                this->cancelInflightParts(START_CALLER ctx);
+
+                // LbVt@C̖O ETag Ɉˑ̂ŁAnh擾
+
                 std::filesystem::path cacheFilePath;
-                if (resolveCacheFilePath(mRuntimeEnv->CacheDataDir, refWinPath, &cacheFilePath))
+                if (GetFileNameFromHandle(ctx->getHandle(), &cacheFilePath))
                 {
                     const auto faBefore = ::GetFileAttributesW(cacheFilePath.c_str());
 
@@ -526,17 +765,26 @@ VOID CSDriver::Cleanup(FileContext* ctx, PCWSTR argWinPath, ULONG argFlags)
                         // nhN[YƂőω
                         // --> FILE_FLAG_DELETE_ON_CLOSE ̉eɂLbVt@C폜ꂽƂ
 
+                        // Abv[h҂łΎ
+
+                        mWriteBack.remove(refWinPath);
+
                         // [g̍폜
 
                         if (!mDevice->deleteObject(START_CALLER ctx->getObjectKey()))
                         {
                             errorW(L"fault: deleteObject");
                         }
+
+                        mCacheIndex.remove(refWinPath, nullptr);
+                        this->dropColdCacheFile(START_CALLER refWinPath);
+                        mBlockCache.invalidate(refWinPath);
+                        mMappedViews.invalidate(refWinPath);
                     }
                 }
                 else
                 {
-                    errorW(L"fault: resolveCacheFilePath refWinPath=%s", refWinPath.c_str());
+                    errorW(L"fault: GetFileNameFromHandle ctx=%s", ctx->str().c_str());
 
                     traceW(L"closeHandle");
                     ctx->closeHandle();
@@ -664,12 +912,46 @@ NTSTATUS CSDriver::Overwrite(FileContext* ctx, UINT32 argFileAttributes, BOOLEAN
         }
     }
 
+    // ؂l߂Ƀ_E[h̃p[g܂Ȃ悤ɁA҂
+
+    auto ntstatus = this->cancelInflightParts(START_CALLER ctx);
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: cancelInflightParts ctx=%s", ctx->str().c_str());
+        return ntstatus;
+    }
+
+    // ̃ubNƃ}bvr[͓eς̂Ŕj
+
+    mBlockCache.invalidate(ctx->getWinPath());
+    mMappedViews.invalidate(ctx->getWinPath());
+
     if (!::SetFileInformationByHandle(Handle, FileAllocationInfo, &AllocationInfo, sizeof AllocationInfo))
     {
         errorW(L"fault: SetFileInformationByHandle ctx=%s", ctx->str().c_str());
         return FspNtStatusFromWin32(::GetLastError());
     }
 
+    // e͑SĔjꂽ̂ŁA[g擾͈͂ȂȂ
+
+    ntstatus = this->updateCacheExtents(START_CALLER ctx, [](CacheExtents* pExtents)
+    {
+        pExtents->reset(0, L"");
+    });
+
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: updateCacheExtents ctx=%s", ctx->str().c_str());
+        return ntstatus;
+    }
+
+    ctx->mDirtyRanges.clear();
+
+    // ̓e珑܂̂ŁA݂ƕsăAbv[hł悤ɂ
+
+    this->cancelOtherStreamUpload(START_CALLER ctx);
+    this->beginStreamUpload(START_CALLER ctx);
+
     // LbVt@C؂l߂Ă̂ŁAt@CD(false)
 
     return this->updateFileInfo(START_CALLER ctx, pFileInfo, false);
@@ -682,41 +964,100 @@ NTSTATUS CSDriver::Read(FileContext* ctx, PVOID argBuffer, UINT64 argOffset, ULO
 
     traceW(L"ctx=%s", ctx->str().c_str());
 
-    // [g̓eƕ (argOffset + argLengh ͈̔)
+    bool downloaded = false;
 
-    const auto ntstatus = this->syncContent(START_CALLER ctx, (FILEIO_OFFSET_T)argOffset, argLength);
-    if (!NT_SUCCESS(ntstatus))
+    const auto fileSize = static_cast<FILEIO_OFFSET_T>(ctx->getDirEntry()->mFileInfo.FileSize);
+
+    // 擾҂KvƂ́Ap[g̊ɉ悤ɕۗ
+
+    std::list<std::shared_ptr<ReadFilePartType>> pendingParts;
+    auto* pPendingParts = mRuntimeEnv->AsyncRead && mFileSystem ? &pendingParts : nullptr;
+
+    bool pending = false;
+
+    if (ctx->mStreamRead.accept(static_cast<FILEIO_OFFSET_T>(argOffset), this->canStreamRead(ctx, static_cast<FILEIO_OFFSET_T>(argOffset))))
     {
-        errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
-        return ntstatus;
-    }
+        // ȃt@C擪珇ɓǂłƂ́ALbVt@CoRȂ
 
-    HANDLE Handle = ctx->getWritableHandle();
+        const auto ntstatus = this->readWithStream(START_CALLER ctx, argBuffer, static_cast<FILEIO_OFFSET_T>(argOffset), argLength, argBytesTransferred);
+        if (!NT_SUCCESS(ntstatus))
+        {
+            errorW(L"fault: readWithStream ctx=%s", ctx->str().c_str());
+            return ntstatus;
+        }
+    }
+    else if (mMappedViews.enabled() && !(ctx->mFlags & FCTX_FLAGS_MODIFY) && static_cast<FILEIO_OFFSET_T>(argOffset) < fileSize &&
+        this->readWithMappedView(START_CALLER ctx, argBuffer, static_cast<FILEIO_OFFSET_T>(argOffset), argLength, argBytesTransferred))
+    {
+        // ŜLbVĂt@ĆA}bvr[Rs[
 
-    OVERLAPPED Overlapped{};
+        traceW(L"mapped: argOffset=%llu argBytesTransferred=%lu", argOffset, *argBytesTransferred);
+    }
+    else if (mBlockCache.enabled() && !(ctx->mFlags & FCTX_FLAGS_MODIFY) &&
+        argLength <= BlockCache::BLOCK_SIZE && static_cast<FILEIO_OFFSET_T>(argOffset) < fileSize)
+    {
+        // eύXĂȂt@Cւ̏ Read ̓̃ubNoR
 
-    Overlapped.Offset     = static_cast<DWORD>(argOffset);
-    Overlapped.OffsetHigh = static_cast<DWORD>(argOffset >> 32);
+        const auto ntstatus = this->readWithBlockCache(START_CALLER ctx, argBuffer, static_cast<FILEIO_OFFSET_T>(argOffset), argLength, argBytesTransferred, &downloaded, pPendingParts);
+        if (ntstatus == STATUS_PENDING)
+        {
+            // ubNLbVt@CɑĂȂ
 
-    traceW(L"ReadFile argOffset=%llu argLength=%lu", argOffset, argLength);
+            pending = true;
+        }
+        else if (!NT_SUCCESS(ntstatus))
+        {
+            if (ntstatus != FspNtStatusFromWin32(ERROR_HANDLE_EOF))
+            {
+                errorW(L"fault: readWithBlockCache ctx=%s", ctx->str().c_str());
+            }
 
-    if (!::ReadFile(Handle, argBuffer, argLength, argBytesTransferred, &Overlapped))
+            return ntstatus;
+        }
+    }
+    else
     {
-        const auto lerr = ::GetLastError();
+        // [g̓eƕ (argOffset + argLengh ͈̔)
+
+        const auto ntstatus = this->syncContent(START_CALLER ctx, (FILEIO_OFFSET_T)argOffset, argLength, &downloaded, pPendingParts);
 
-        if (lerr == ERROR_HANDLE_EOF)
+        if (ntstatus == STATUS_PENDING)
         {
-            traceW(L"EOF");
+            pending = true;
+        }
+        else if (!NT_SUCCESS(ntstatus))
+        {
+            errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
+            return ntstatus;
         }
         else
         {
-            errorW(L"fault: ReadFile ctx=%s", ctx->str().c_str());
+            const auto ntstatusRead = this->readCacheFile(START_CALLER ctx, argBuffer, (FILEIO_OFFSET_T)argOffset, argLength, argBytesTransferred);
+            if (!NT_SUCCESS(ntstatusRead))
+            {
+                return ntstatusRead;
+            }
         }
+    }
+
+    if (pending)
+    {
+        // ǂ݂͕ۗOɓo^Ă
+
+        const auto readLength = min(static_cast<FILEIO_LENGTH_T>(argLength), fileSize - static_cast<FILEIO_OFFSET_T>(argOffset));
 
-        return FspNtStatusFromWin32(lerr);
+        this->readAhead(START_CALLER ctx, (FILEIO_OFFSET_T)argOffset, max(readLength, 0LL), downloaded);
+
+        return this->pendRead(START_CALLER ctx, argBuffer, (FILEIO_OFFSET_T)argOffset, argLength, pendingParts, argBytesTransferred);
     }
 
-    traceW(L"success: ReadFile argBytesTransferred=%lu", *argBytesTransferred);
+    // A Read ł΁Ax^XNŐǂ݂
+    // --> LbVt@CoRȂƂ́AStreamRead ̃p[g擾Ă
+
+    if (!ctx->mStreamRead.isActive())
+    {
+        this->readAhead(START_CALLER ctx, (FILEIO_OFFSET_T)argOffset, *argBytesTransferred, downloaded);
+    }
 
 #if GET_MIME_TYPE
     if (argOffset == 0 && *argBytesTransferred)
@@ -779,7 +1120,14 @@ NTSTATUS CSDriver::ReadDirectory(FileContext* ctx, PCWSTR argPattern, PWSTR argM
         return refWinPath == parentPath;
     };
 
-    const auto openDirEntry{ mOpenDirEntry.copy_if(is_same_dir) };
+    auto openDirEntry{ mOpenDirEntry.copy_if(is_same_dir) };
+
+    // Abv[h҂̂̂[J̏Ԃ\
+    // --> I[v̂̂΂D
+
+    const auto writeBackDirEntry{ mWriteBack.copy_if(is_same_dir) };
+
+    openDirEntry.insert(writeBackDirEntry.cbegin(), writeBackDirEntry.cend());
 
     std::optional<std::wregex> reWildcard;
 
@@ -865,6 +1213,12 @@ NTSTATUS CSDriver::ReadDirectory(FileContext* ctx, PCWSTR argPattern, PWSTR argM
 
     NTSTATUS fspNtstatus = STATUS_UNSUCCESSFUL;
 
+    // ꗗ̎擾IAȃt@CobNOEhŎ擾Ă
+    // --> ĊJꂽƂɃ[g҂ɍςނ悤
+
+    const bool prefetch = !argMarker && mRuntimeEnv->PrefetchFileMaxSizeKib > 0;
+    std::list<std::pair<std::filesystem::path, DirEntryType>> prefetchCandidates;
+
     if (FspFileSystemAcquireDirectoryBuffer(&ctx->mDirBuffer, 0 == argMarker, &fspNtstatus))
     {
         std::set<std::filesystem::path> already;
@@ -909,6 +1263,11 @@ NTSTATUS CSDriver::ReadDirectory(FileContext* ctx, PCWSTR argPattern, PWSTR argM
                 {
                     memset(dirInfo, 0, dirInfoAllocSize);
                     dirEntry->getDirInfo(dirInfo);
+
+                    if (prefetch && dirEntry->mFileType == FileTypeEnum::File)
+                    {
+                        prefetchCandidates.emplace_back(winPath, dirEntry);
+                    }
                 }
                 else
                 {
@@ -979,6 +1338,11 @@ NTSTATUS CSDriver::ReadDirectory(FileContext* ctx, PCWSTR argPattern, PWSTR argM
 
     FspFileSystemReadDirectoryBuffer(&ctx->mDirBuffer, argMarker, argBuffer, argBufferLength, argBytesTransferred);
 
+    if (!prefetchCandidates.empty())
+    {
+        this->prefetchSmallFiles(START_CALLER prefetchCandidates);
+    }
+
     return STATUS_SUCCESS;
 }
 
@@ -1037,8 +1401,39 @@ NTSTATUS CSDriver::Rename(FileContext* ctx, const std::filesystem::path& argSrcW
             traceW(L"not empty srcObjKey=%s", srcObjKey.c_str());
             return STATUS_DIRECTORY_NOT_EMPTY;
         }
+
+        // Abv[h҂̃t@C̓[gɑ݂ȂĂgƂĈ
+
+        const auto& refSrcWinPath{ ctx->getWinPath() };
+
+        const auto writeBackDirEntry{ mWriteBack.copy_if([&refSrcWinPath](const auto& value)
+        {
+            return value.first.parent_path() == refSrcWinPath;
+        }) };
+
+        if (!writeBackDirEntry.empty())
+        {
+            traceW(L"write back in refSrcWinPath=%s", refSrcWinPath.c_str());
+            return STATUS_DIRECTORY_NOT_EMPTY;
+        }
+    }
+    else if (mWriteBack.contains(ctx->getWinPath()))
+    {
+        // Abv[h҂̓eɑA[gŐVɂĂRs[
+        // --> t@C̔r RelayRename ōsĂ
+
+        if (!this->uploadWriteBack(START_CALLER ctx->getWinPath()))
+        {
+            errorW(L"fault: uploadWriteBack ctx=%s", ctx->str().c_str());
+            return FspNtStatusFromWin32(ERROR_IO_DEVICE);
+        }
     }
 
+    // Abv[h悪ς̂ŁA݂ƕsAbv[h͒f
+    // --> ύXꂽe̓N[YɃl[փAbv[h
+
+    this->endStreamUpload(START_CALLER ctx);
+
     const auto dstObjKey{ *optDstObjKey };
 
     traceW(L"dstObjKey=%s", dstObjKey.c_str());
@@ -1093,11 +1488,46 @@ NTSTATUS CSDriver::Rename(FileContext* ctx, const std::filesystem::path& argSrcW
             return FspNtStatusFromWin32(::GetLastError());
         }
 
+        // l[ɏރ_E[h̃p[g𒆒fāA҂
+
+        ntstatus = this->cancelInflightParts(START_CALLER ctx);
+        if (!NT_SUCCESS(ntstatus))
+        {
+            errorW(L"fault: cancelInflightParts ctx=%s", ctx->str().c_str());
+            return ntstatus;
+        }
+
+        // l[ ETag 擾
+        // --> 擾łȂƂ̓l[̂̂p
+
+        auto dstETag{ getDirEntryETag(ctx->getDirEntry()) };
+
+        DirEntryType copiedDirEntry;
+
+        if (mDevice->headObject(START_CALLER dstObjKey, &copiedDirEntry))
+        {
+            const auto copiedETag{ getDirEntryETag(copiedDirEntry) };
+
+            if (!copiedETag.empty())
+            {
+                dstETag = copiedETag;
+            }
+        }
+        else
+        {
+            traceW(L"warn: headObject dstObjKey=%s", dstObjKey.c_str());
+        }
+
+        if (!dstETag.empty())
+        {
+            dstDirEntry->mUserProperties[L"wincse-etag"] = dstETag;
+        }
+
         // l[̃LbVEt@C쐬
 
         std::filesystem::path dstCacheFilePath;
 
-        if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, argDstWinPath, &dstCacheFilePath))
+        if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, argDstWinPath, dstETag, &dstCacheFilePath))
         {
             errorW(L"fault: resolveCacheFilePath argDstWinPath=%s", argDstWinPath.c_str());
             return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
@@ -1114,6 +1544,32 @@ NTSTATUS CSDriver::Rename(FileContext* ctx, const std::filesystem::path& argSrcW
 
             return FspNtStatusFromWin32(lerr);
         }
+
+        // nhɑΉpXς
+
+        mCacheStateEpoch++;
+
+        // e͓Ȃ̂ŁA_E[hς͈̔͂͂̂܂܈p
+
+        ntstatus = this->updateCacheExtents(START_CALLER dstCacheFilePath, [&dstETag](CacheExtents* pExtents)
+        {
+            if (!pExtents->getETag().empty())
+            {
+                pExtents->setETag(dstETag);
+            }
+        });
+
+        if (!NT_SUCCESS(ntstatus))
+        {
+            errorW(L"fault: updateCacheExtents dstCacheFilePath=%s", dstCacheFilePath.c_str());
+            return ntstatus;
+        }
+
+        mCacheIndex.remove(ctx->getWinPath(), nullptr);
+        this->dropColdCacheFile(START_CALLER ctx->getWinPath());
+        mBlockCache.invalidate(ctx->getWinPath());
+        mMappedViews.invalidate(ctx->getWinPath());
+        mCacheIndex.set(argDstWinPath, dstCacheFilePath, dstETag, srcFileInfo.FileSize);
     }
 
     // [g̃l[폜
@@ -1205,16 +1661,24 @@ NTSTATUS CSDriver::SetFileSize(FileContext* ctx, UINT64 argNewSize, BOOLEAN argS
 
     traceW(L"argNewSize=%llu argSetAllocationSize=%s ctx=%s", argNewSize, BOOL_CSTRW(argSetAllocationSize), ctx->str().c_str());
 
-    // _E[h擾
+    // LbVt@C̓[gƓTCỸXp[XEt@CȂ̂ŁA_E[h
+    // TCYύXA؂l߂ꂽ͈͈͂͏񂩂폜
 
-    auto ntstatus = this->syncContent(START_CALLER ctx, 0, (FILEIO_LENGTH_T)argNewSize);
+    HANDLE Handle = ctx->getWritableHandle();
+
+    // ύXTCYȍ~Ƀ_E[h̃p[g܂Ȃ悤ɁA҂
+
+    auto ntstatus = this->cancelInflightParts(START_CALLER ctx);
     if (!NT_SUCCESS(ntstatus))
     {
-        errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
+        errorW(L"fault: cancelInflightParts ctx=%s", ctx->str().c_str());
         return ntstatus;
     }
 
-    HANDLE Handle = ctx->getWritableHandle();
+    // ̃ubNƃ}bvr[͓eς̂Ŕj
+
+    mBlockCache.invalidate(ctx->getWinPath());
+    mMappedViews.invalidate(ctx->getWinPath());
 
     FILE_ALLOCATION_INFO AllocationInfo{};
     FILE_END_OF_FILE_INFO EndOfFileInfo{};
@@ -1251,7 +1715,38 @@ NTSTATUS CSDriver::SetFileSize(FileContext* ctx, UINT64 argNewSize, BOOLEAN argS
         }
     }
 
-    // t@CTCY̕ύXɕKvȕ͓ĂA[J̃t@CTCYD(false)
+    LARGE_INTEGER FileSize{};
+
+    if (!::GetFileSizeEx(Handle, &FileSize))
+    {
+        errorW(L"fault: GetFileSizeEx ctx=%s", ctx->str().c_str());
+        return FspNtStatusFromWin32(::GetLastError());
+    }
+
+    // gꂽ̓[g̃TCY𒴂̂ŁA[Jō쐬ꂽ͈͂ƂĈ
+
+    ntstatus = this->updateCacheExtents(START_CALLER ctx, [&FileSize](CacheExtents* pExtents)
+    {
+        pExtents->truncate(FileSize.QuadPart);
+        pExtents->markModified();
+    });
+
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: updateCacheExtents ctx=%s", ctx->str().c_str());
+        return ntstatus;
+    }
+
+    ctx->mDirtyRanges.truncate(FileSize.QuadPart);
+
+    this->cancelOtherStreamUpload(START_CALLER ctx);
+
+    if (ctx->mStreamUpload)
+    {
+        ctx->mStreamUpload->truncate(FileSize.QuadPart);
+    }
+
+    // LbVt@C̃TCŶ܂ܐVTCYƂȂ̂ŁA[J̃t@CTCYD(false)
 
     return this->updateFileInfo(START_CALLER ctx, pFileInfo, false);
     //return GetFileInfoInternal(Handle, pFileInfo);
@@ -1270,14 +1765,8 @@ NTSTATUS CSDriver::Write(FileContext* ctx, PVOID argBuffer, UINT64 argOffset, UL
 
     traceW(L"ctx=%s", ctx->str().c_str());
 
-    // [g̓eƕ (argOffset + argLengh ͈̔)
-
-    auto ntstatus = this->syncContent(START_CALLER ctx, (FILEIO_OFFSET_T)argOffset, (FILEIO_LENGTH_T)argLength);
-    if (!NT_SUCCESS(ntstatus))
-    {
-        errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
-        return ntstatus;
-    }
+    // ޔ͈͂̓_E[h̕KvȂ̂ŁA[gƂ͍̓sȂ
+    // --> ݌ɔ͈͏ɋL^Ȃ̖擾͈̔͂ Read Ɏ擾
 
     HANDLE Handle = ctx->getWritableHandle();
     LARGE_INTEGER FileSize{};
@@ -1302,10 +1791,40 @@ NTSTATUS CSDriver::Write(FileContext* ctx, PVOID argBuffer, UINT64 argOffset, UL
         }
     }
 
-    Overlapped.Offset = static_cast<DWORD>(argOffset);
-    Overlapped.OffsetHigh = static_cast<DWORD>(argOffset >> 32);
+    // ވʒu
+    // --> t@C̖ւ̒ǋĹA͈͂L^ł悤Ɍ݂̃t@CTCY狁߂
+
+    auto writeOffset = static_cast<FILEIO_OFFSET_T>(argOffset);
+
+    if (argWriteToEndOfFile)
+    {
+        if (!::GetFileSizeEx(Handle, &FileSize))
+        {
+            errorW(L"fault: GetFileSizeEx ctx=%s", ctx->str().c_str());
+            return FspNtStatusFromWin32(::GetLastError());
+        }
+
+        writeOffset = FileSize.QuadPart;
+    }
+
+    // ޔ͈͂_E[hłΊ҂
+
+    const auto ntstatusWait = this->waitInflightParts(START_CALLER ctx, writeOffset, argLength);
+    if (!NT_SUCCESS(ntstatusWait))
+    {
+        errorW(L"fault: waitInflightParts ctx=%s", ctx->str().c_str());
+        return ntstatusWait;
+    }
+
+    // ̃ubNƃ}bvr[͓eς̂Ŕj
+
+    mBlockCache.invalidate(ctx->getWinPath());
+    mMappedViews.invalidate(ctx->getWinPath());
 
-    traceW(L"WriteFile argOffset=%llu argLength=%lu", argOffset, argLength);
+    Overlapped.Offset = static_cast<DWORD>(writeOffset);
+    Overlapped.OffsetHigh = static_cast<DWORD>(writeOffset >> 32);
+
+    traceW(L"WriteFile writeOffset=%lld argLength=%lu", writeOffset, argLength);
 
     if (!::WriteFile(Handle, argBuffer, argLength, argBytesTransferred, &Overlapped))
     {
@@ -1315,7 +1834,33 @@ NTSTATUS CSDriver::Write(FileContext* ctx, PVOID argBuffer, UINT64 argOffset, UL
 
     traceW(L"success: WriteFile argBytesTransferred=%lu", *argBytesTransferred);
 
-    // Write ɕKvȕ̂ݓĂ邽߁A[g̃t@CTCYD(true)
+    // 񂾔͈͂𑶍݂͈͂ƂċL^AύXꂽ͈͂ɂ
+    // --> ǋL͈͂܂߂
+
+    const auto ntstatus = this->updateCacheExtents(START_CALLER ctx, [writeOffset, argBytesTransferred](CacheExtents* pExtents)
+    {
+        pExtents->add(writeOffset, *argBytesTransferred);
+        pExtents->markModified();
+    });
+
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: updateCacheExtents ctx=%s", ctx->str().c_str());
+        return ntstatus;
+    }
+
+    ctx->mDirtyRanges.add(writeOffset, *argBytesTransferred);
+
+    // ݂ƕsAbv[hɁA񂾔͈͂ʒm
+
+    this->cancelOtherStreamUpload(START_CALLER ctx);
+
+    if (ctx->mStreamUpload)
+    {
+        ctx->mStreamUpload->write(START_CALLER writeOffset, *argBytesTransferred);
+    }
+
+    // 񂾕ȊO͖擾̉\邽߁A[g̃t@CTCYD(true)
 
     return this->updateFileInfo(START_CALLER ctx, pFileInfo, true);
     //return GetFileInfoInternal(Handle, pFileInfo);
@@ -1417,7 +1962,19 @@ NTSTATUS CSDriver::SetDelete(FileContext* ctx, PCWSTR argFileName, BOOLEAN argDe
 
                     std::filesystem::path cacheFilePath;
 
-                    if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, winPath, &cacheFilePath))
+                    CacheIndex::Entry entry;
+
+                    mBlockCache.invalidate(winPath);
+                    mMappedViews.invalidate(winPath);
+                    mWriteBack.remove(winPath);
+
+                    this->dropColdCacheFile(START_CALLER winPath);
+
+                    if (mCacheIndex.remove(winPath, &entry))
+                    {
+                        cacheFilePath = std::move(entry.mCacheFilePath);
+                    }
+                    else if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, winPath, getDirEntryETag(dirEntry), &cacheFilePath))
                     {
                         errorW(L"fault: resolveCacheFilePath winPath=%s", winPath.c_str());
                         return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
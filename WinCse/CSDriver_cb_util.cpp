@@ -15,17 +15,36 @@ static bool syncFileTimes(const FSP_FSCTL_FILE_INFO& fileInfo, HANDLE hFile)
     return ::SetFileTime(hFile, &ftCreation, &ftLastAccess, &ftLastWrite);
 }
 
-using ReadFilePartType = CSELIB::FilePart<FILEIO_LENGTH_T>;
+static bool hasTrailingIndex(const std::filesystem::path& argWinPath)
+{
+    //  (Ɛ擪) ɖڎ`
+    // --> zip ñZgEfBNgAParquet/ORC ̃tb^AMP4  moov Ȃ
+
+    static const std::set<std::wstring> extensions
+    {
+        L".zip", L".jar", L".apk", L".docx", L".xlsx", L".pptx", L".epub", L".whl", L".nupkg",
+        L".7z", L".parquet", L".orc", L".pdf",
+        L".mp4", L".m4a", L".m4v", L".mov", L".3gp",
+    };
+
+    auto ext{ argWinPath.extension().wstring() };
+
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::towlower);
+
+    return extensions.find(ext) != extensions.cend();
+}
+
+namespace CSEDRV {
 
 struct ReadFilePartTask : public IOnDemandTask
 {
-    ICSDevice* mThat;
+    CSDriver* mThat;
     const ObjectKey mObjKey;
     const std::filesystem::path mOutputPath;
     std::shared_ptr<ReadFilePartType> mFilePart;
 
     ReadFilePartTask(
-        ICSDevice* argThat,
+        CSDriver* argThat,
         const ObjectKey& argObjKey,
         const std::filesystem::path& argOutputPath,
         const std::shared_ptr<ReadFilePartType>& argFilePart)
@@ -45,16 +64,9 @@ struct ReadFilePartTask : public IOnDemandTask
 
         try
         {
-            if (mFilePart->mInterrupt)
-            {
-                errorW(L"@%d Interruption request received", argThreadIndex);
-            }
-            else
-            {
-                traceW(L"@%d getObjectAndWriteFile", argThreadIndex);
+            traceW(L"@%d readFilePart", argThreadIndex);
 
-                result = mThat->getObjectAndWriteFile(START_CALLER mObjKey, mOutputPath, mFilePart->mOffset, mFilePart->mLength);
-            }
+            result = mThat->readFilePart(START_CALLER mObjKey, mOutputPath, mFilePart);
         }
         catch (const std::exception& ex)
         {
@@ -68,13 +80,161 @@ struct ReadFilePartTask : public IOnDemandTask
         // ʂݒ肵AVOiԂɕύX
         // --> WaitForSingleObject őҋ@ĂXbh̃bN
 
+        mThat->completeFilePart(mOutputPath, mFilePart, result);
+    }
+
+    void cancelled() override
+    {
+        // sꂸɔjƂҋ@ĂXbh̃bN
+
+        mThat->completeFilePart(mOutputPath, mFilePart, -1LL);
+    }
+};
+
+struct StreamFilePartTask : public IOnDemandTask
+{
+    CSDriver* mThat;
+    const ObjectKey mObjKey;
+    const std::wstring mETag;
+    std::shared_ptr<StreamFilePart> mFilePart;
+
+    StreamFilePartTask(
+        CSDriver* argThat,
+        const ObjectKey& argObjKey,
+        const std::wstring& argETag,
+        const std::shared_ptr<StreamFilePart>& argFilePart)
+        :
+        mThat(argThat),
+        mObjKey(argObjKey),
+        mETag(argETag),
+        mFilePart(argFilePart)
+    {
+    }
+
+    void run(int argThreadIndex) override
+    {
+        NEW_LOG_BLOCK();
+
+        FILEIO_LENGTH_T result = -1LL;
+
+        try
+        {
+            traceW(L"@%d streamFilePart", argThreadIndex);
+
+            result = mThat->streamFilePart(START_CALLER mObjKey, mETag, mFilePart);
+        }
+        catch (const std::exception& ex)
+        {
+            errorA("catch exception: what=[%s]", ex.what());
+        }
+        catch (...)
+        {
+            errorW(L"catch unknown");
+        }
+
         mFilePart->setResult(result);
     }
+
+    void cancelled() override
+    {
+        mFilePart->setResult(-1LL);
+    }
 };
 
-namespace CSEDRV {
+struct PrefetchFileTask : public IOnDemandTask
+{
+    CSDriver* mThat;
+    const std::filesystem::path mWinPath;
+
+    PrefetchFileTask(
+        CSDriver* argThat,
+        const std::filesystem::path& argWinPath)
+        :
+        mThat(argThat),
+        mWinPath(argWinPath)
+    {
+    }
+
+    bool isLowPriority() const override
+    {
+        // p҂̑ɂ Read ȂǂD悳
+
+        return true;
+    }
 
-bool resolveCacheFilePath(const std::filesystem::path& argDir, const std::wstring& argWinPath, std::filesystem::path* pPath)
+    void run(int argThreadIndex) override
+    {
+        NEW_LOG_BLOCK();
+
+        try
+        {
+            traceW(L"@%d prefetchFile", argThreadIndex);
+
+            mThat->prefetchFile(START_CALLER mWinPath);
+        }
+        catch (const std::exception& ex)
+        {
+            errorA("catch exception: what=[%s]", ex.what());
+        }
+        catch (...)
+        {
+            errorW(L"catch unknown");
+        }
+
+        mThat->endPrefetch(mWinPath);
+    }
+
+    void cancelled() override
+    {
+        mThat->endPrefetch(mWinPath);
+    }
+};
+
+struct PendingRead
+{
+    FileContext* const mCtx;
+    const PVOID mBuffer;
+    const FILEIO_OFFSET_T mOffset;
+    const ULONG mLength;
+    const UINT64 mHint;
+
+    // ҂p[g̐ (o^ +1)
+
+    std::atomic<size_t> mRemaining;
+
+    PendingRead(FileContext* argCtx, PVOID argBuffer, FILEIO_OFFSET_T argOffset, ULONG argLength, UINT64 argHint, size_t argRemaining)
+        :
+        mCtx(argCtx),
+        mBuffer(argBuffer),
+        mOffset(argOffset),
+        mLength(argLength),
+        mHint(argHint),
+        mRemaining(argRemaining)
+    {
+    }
+};
+
+std::wstring getDirEntryETag(const DirEntryType& argDirEntry)
+{
+    const auto it{ argDirEntry->mUserProperties.find(L"wincse-etag") };
+
+    return it == argDirEntry->mUserProperties.cend() ? std::wstring{} : it->second;
+}
+
+std::wstring getContentVersion(const DirEntryType& argDirEntry)
+{
+    // ETag sȂƂ̂ŁATCYƍXV܂߂
+
+    std::wostringstream ss;
+
+    ss << getDirEntryETag(argDirEntry);
+    ss << L':' << argDirEntry->mFileInfo.FileSize;
+    ss << L':' << argDirEntry->mFileInfo.LastWriteTime;
+
+    return ss.str();
+}
+
+bool resolveCacheFilePath(const std::filesystem::path& argDir, const std::wstring& argWinPath, const std::wstring& argETag, std::filesystem::path* pPath)
 {
     NEW_LOG_BLOCK();
 
@@ -84,12 +244,17 @@ bool resolveCacheFilePath(const std::filesystem::path& argDir, const std::wstrin
         return false;
     }
 
+    // (oPbg, L[, ETag) 疼O쐬
+    // --> ETag s ([Jō쐬t@C) ̂Ƃ̓pX̂
+
+    const auto contentKey{ argETag.empty() ? argWinPath : argWinPath + L'\n' + argETag };
+
     std::wstring nameSha256;
 
-    const auto ntstatus = ComputeSHA256W(argWinPath, &nameSha256);
+    const auto ntstatus = ComputeSHA256W(contentKey, &nameSha256);
     if (!NT_SUCCESS(ntstatus))
     {
-        errorW(L"fault: ComputeSHA256W argWinPath=%s", argWinPath.c_str());
+        errorW(L"fault: ComputeSHA256W contentKey=%s", contentKey.c_str());
         return false;
     }
 
@@ -119,7 +284,7 @@ NTSTATUS syncAttributes(const DirEntryType& remoteDirEntry, const std::filesyste
 
     FileHandle file = ::CreateFileW(
         cacheFilePath.c_str(),
-        GENERIC_WRITE,
+        GENERIC_READ | GENERIC_WRITE,
         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
         NULL,
         OPEN_ALWAYS,
@@ -143,12 +308,42 @@ NTSTATUS syncAttributes(const DirEntryType& remoteDirEntry, const std::filesyste
         return ntstatus;
     }
 
-    if (localInfo.CreationTime  == remoteDirEntry->mFileInfo.CreationTime &&
-        localInfo.LastWriteTime == remoteDirEntry->mFileInfo.LastWriteTime)
+    const auto remoteETag{ getDirEntryETag(remoteDirEntry) };
+
+    CacheExtents extents;
+    bool inSync = false;
+
+    const bool loaded = extents.load(cacheFilePath);
+
+    if (loaded && !remoteETag.empty() && extents.getETag().empty())
+    {
+        // [JŕύXꂽe (ETag ) ̓Abv[hOȂ̂Ő؂l߂Ȃ
+        // --> TCY[gƈقȂ\̂ŁATCYɔ肷
+
+        traceW(L"Locally modified extents=%s", extents.str().c_str());
+        return STATUS_SUCCESS;
+    }
+
+    if (loaded && localInfo.FileSize == remoteDirEntry->mFileInfo.FileSize)
     {
-        // ̃^CX^vƂ͓ƍl
+        if (remoteETag.empty())
+        {
+            // ETag 킩ȂƂ́A^CX^vŔf
+
+            inSync = localInfo.CreationTime  == remoteDirEntry->mFileInfo.CreationTime &&
+                     localInfo.LastWriteTime == remoteDirEntry->mFileInfo.LastWriteTime;
+        }
+        else
+        {
+            // ETag ł΃^CX^v͔rȂ
 
-        traceW(L"In sync");
+            inSync = extents.getETag() == remoteETag;
+        }
+    }
+
+    if (inSync)
+    {
+        traceW(L"In sync extents=%s", extents.str().c_str());
     }
     else
     {
@@ -189,6 +384,41 @@ NTSTATUS syncAttributes(const DirEntryType& remoteDirEntry, const std::filesyste
 #endif
         }
 
+        // [gƓTCỸXp[XEt@Cɂ
+        // --> _E[hĂȂ͈͂̓fBXNȂ
+
+        DWORD bytesReturned = 0;
+
+        if (!::DeviceIoControl(file.handle(), FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &bytesReturned, NULL))
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: DeviceIoControl lerr=%lu file=%s", lerr, file.str().c_str());
+            return FspNtStatusFromWin32(lerr);
+        }
+
+        FILE_END_OF_FILE_INFO EndOfFileInfo{};
+        EndOfFileInfo.EndOfFile.QuadPart = remoteDirEntry->mFileInfo.FileSize;
+
+        if (!::SetFileInformationByHandle(file.handle(), FileEndOfFileInfo, &EndOfFileInfo, sizeof EndOfFileInfo))
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: SetFileInformationByHandle lerr=%lu file=%s", lerr, file.str().c_str());
+            return FspNtStatusFromWin32(lerr);
+        }
+
+        // ͈͏
+        // --> ^CX^vς\̂ŁAOɎ{
+
+        extents.reset(remoteDirEntry->mFileInfo.FileSize, remoteETag);
+
+        if (!extents.save(cacheFilePath))
+        {
+            errorW(L"fault: save cacheFilePath=%s", cacheFilePath.c_str());
+            return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
+        }
+
         // ^CX^v𓯊
 
         if (!syncFileTimes(remoteDirEntry->mFileInfo, file.handle()))
@@ -240,230 +470,1384 @@ NTSTATUS CSDriver::updateFileInfo(CALLER_ARG FileContext* ctx, FSP_FSCTL_FILE_IN
     return STATUS_SUCCESS;
 }
 
-NTSTATUS CSDriver::syncContent(CALLER_ARG FileContext* ctx, FILEIO_OFFSET_T argReadOffset, FILEIO_LENGTH_T argReadLength)
+bool CSDriver::getCacheFilePath(FileContext* ctx, std::filesystem::path* pPath)
 {
-    NEW_LOG_BLOCK();
+    // nhɑΉpX́ALbVt@Cl[܂ŕςȂ
 
-    traceW(L"ctx=%s argReadOffset=%lld argReadLength=%lld", ctx->str().c_str(), argReadOffset, argReadLength);
+    const auto epoch = mCacheStateEpoch.load();
 
-    if (argReadLength == 0)
+    if (ctx->mCacheState.getPath(epoch, pPath))
     {
-        traceW(L"Empty read");
-        return STATUS_SUCCESS;
+        return true;
     }
 
-    const auto& fileInfo{ ctx->getDirEntry()->mFileInfo };
-
-    if (fileInfo.FileSize == 0)
+    if (!GetFileNameFromHandle(ctx->getHandle(), pPath))
     {
-        traceW(L"Empty content");
-        return STATUS_SUCCESS;
+        return false;
     }
 
-    // t@CEnh烍[J̃t@C擾
+    ctx->mCacheState.setPath(epoch, *pPath);
 
-    std::filesystem::path filePath;
+    return true;
+}
 
-    if (!GetFileNameFromHandle(ctx->getHandle(), &filePath))
-    {
-        const auto lerr = ::GetLastError();
+bool CSDriver::loadCacheExtents(const std::filesystem::path& argCacheFilePath, CacheExtents* pExtents)
+{
+    // x^XNXV邱Ƃ̂Ŕr
 
-        errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
-        return FspNtStatusFromWin32(lerr);
-    }
+    std::lock_guard<std::mutex> lock_{ mCacheExtentsGuard };
 
-    traceW(L"filePath=%s", filePath.c_str());
+    return pExtents->load(argCacheFilePath);
+}
 
-    // t@CTCY擾
+NTSTATUS CSDriver::updateCacheExtents(CALLER_ARG const std::filesystem::path& argCacheFilePath, const std::function<void(CacheExtents*)>& callback)
+{
+    NEW_LOG_BLOCK();
 
-    const auto fileSize = GetFileSize(filePath);
-    if (fileSize < 0)
-    {
-        errorW(L"fault: getFileSize");
-        return FspNtStatusFromWin32(::GetLastError());
-    }
+    std::lock_guard<std::mutex> lock_{ mCacheExtentsGuard };
 
-    traceW(L"fileSize=%lld", fileSize);
+    // LbVt@C͈̔͏ǂݍ݁AύXĕۑ
 
-    // t@CTCYƃ[g̑r
+    CacheExtents extents;
 
-    if (fileSize >= (FILESIZE_T)fileInfo.FileSize)
+    if (!extents.load(argCacheFilePath))
     {
-        // Să_E[hςȂ̂ OK
-        // 
-        // --> t@C؂l߂ꍇ̓fBNgGgύXĂ
-
-        traceW(L"All content has been downloaded");
-        return STATUS_SUCCESS;
+        errorW(L"fault: load argCacheFilePath=%s", argCacheFilePath.c_str());
+        return FspNtStatusFromWin32(ERROR_IO_DEVICE);
     }
 
-    // t@CETCY Read Ώ۔͈͂r
+    const auto prevETag{ extents.getETag() };
+    const auto prevRemoteSize = extents.getRemoteSize();
+    const auto prevPresentBytes = extents.presentBytes();
 
-    FILEIO_LENGTH_T fileSizeToRead = argReadOffset + argReadLength;
+    callback(&extents);
 
-    if (fileSize >= fileSizeToRead)
-    {
-        // Read ͈͂̃f[^݂͑̂ OK
+    traceW(L"extents=%s", extents.str().c_str());
 
-        traceW(L"Download not required");
-        return STATUS_SUCCESS;
+    if (!extents.save(argCacheFilePath))
+    {
+        errorW(L"fault: save argCacheFilePath=%s", argCacheFilePath.c_str());
+        return FspNtStatusFromWin32(ERROR_WRITE_FAULT);
     }
 
-    traceW(L"fileSizeToRead=%lld", fileSizeToRead);
-
-    // Read ͈͂̃f[^sĂ̂Ń_E[h{
+    if (extents.getETag() != prevETag || extents.getRemoteSize() < prevRemoteSize || extents.presentBytes() < prevPresentBytes)
+    {
+        // ͈͂kꂽ (܂̓[gς) ̂ŁAFileContext ێԂ𖳌ɂ
 
-    APP_ASSERT(fileSize < static_cast<FILESIZE_T>(fileInfo.FileSize));
-    APP_ASSERT(fileSize < fileSizeToRead);
+        mCacheStateEpoch++;
+    }
 
-    // }`p[ĝ̃p[gTCY
+    return STATUS_SUCCESS;
+}
 
-#if 0
-    traceW(L"!!");
-    traceW(L"!! WARNING: PART SIZE !!");
-    traceW(L"!!");
+NTSTATUS CSDriver::updateCacheExtents(CALLER_ARG FileContext* ctx, const std::function<void(CacheExtents*)>& callback)
+{
+    NEW_LOG_BLOCK();
 
-    const auto PART_SIZE_BYTE = ILESIZE_1Bll * 10;
+    // t@CEnh烍[J̃t@C擾
 
-#else
-    auto PART_SIZE_BYTE = FILESIZE_1MiBll * mRuntimeEnv->TransferReadSizeMib;
+    std::filesystem::path filePath;
 
-    if (argReadOffset == 0 && fileSizeToRead <= FILESIZE_1MiBll)
+    if (!this->getCacheFilePath(ctx, &filePath))
     {
-        // GNXv[ŃvpeBJƃ^f[^ǂݎ邱ƂɑΉ
-        // --> 擪 1MiB ܂ł Read ̏ꍇ̓p[gTCY 1MiB ɐݒ
+        const auto lerr = ::GetLastError();
 
-        PART_SIZE_BYTE = FILESIZE_1MiBll;
+        errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+        return FspNtStatusFromWin32(lerr);
     }
 
-#endif
-    traceW(L"PART_SIZE_BYTE=%lld", PART_SIZE_BYTE);
+    return this->updateCacheExtents(CONT_CALLER filePath, callback);
+}
 
-    const auto& objKey{ ctx->getObjectKey() };
+FILEIO_LENGTH_T CSDriver::readFilePart(CALLER_ARG const ObjectKey& argObjKey, const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart)
+{
+    NEW_LOG_BLOCK();
+
+    if (argFilePart->mInterrupt)
+    {
+        errorW(L"Interruption request received filePart=%s", argFilePart->str().c_str());
+        return -1LL;
+    }
 
-    // ACgTCYɒ
+    // LbVt@CɋL^ꂽ ETag ƓêƂ擾
+    // --> fꂽ擾ĊJƂɁAقȂł̓e݂Ȃ悤
 
-    auto alignedFileSizeToRead = ALIGN_TO_UNIT(fileSizeToRead, PART_SIZE_BYTE);
+    CacheExtents extents;
 
-    if (static_cast<FILESIZE_T>(fileInfo.FileSize) < alignedFileSizeToRead)
+    if (!this->loadCacheExtents(argCacheFilePath, &extents))
     {
-        // [g̃TCY Read Ώۂ̏Ƃ
-
-        alignedFileSizeToRead = fileInfo.FileSize;
+        errorW(L"fault: loadCacheExtents argCacheFilePath=%s", argCacheFilePath.c_str());
+        return -1LL;
     }
 
-    APP_ASSERT(alignedFileSizeToRead <= static_cast<FILESIZE_T>(fileInfo.FileSize));
+    // ɓ]p[g̘g󂭂܂ő҂
 
-    // eϐ̒l̊֌W
-    // 
-    // [fileSize] < [fileSizeToRead] <= [alignedFileSizeToRead] <= [fileInfo.FileSize]
+    TransferTuner::Slot slot{ &mReadTuner };
 
-    // KvƂȂTCY
+    const auto startMillis = GetCurrentUtcMillis();
 
-    const auto requiredSizeBytes = alignedFileSizeToRead - fileSize;
+    const auto readBytes = mDevice->getObjectAndWriteFile(CONT_CALLER argObjKey, argCacheFilePath, argFilePart->mOffset, argFilePart->mLength, extents.getETag());
 
-    traceW(L"requiredSizeBytes=%lld", requiredSizeBytes);
+    if (readBytes != argFilePart->mLength)
+    {
+        errorW(L"fault: getObjectAndWriteFile mLength=%lld readBytes=%lld", argFilePart->mLength, readBytes);
+        return -1LL;
+    }
 
-    // 擾̈쐬
+    // p[gTCYƓs̒ɗp
 
-    const auto partCount = UNIT_COUNT(requiredSizeBytes, PART_SIZE_BYTE);
+    slot.complete(readBytes);
 
-    std::list<std::shared_ptr<ReadFilePartType>> fileParts;
+    // p[g̎擾ɂԂL^
+    // --> ǂ݂p[ǧvZɗp
 
-    auto remaining = requiredSizeBytes;
-        
-    for (int i=0; i<partCount; i++)
-    {
-        // TCYƂ FilePart 쐬
+    const auto endMillis = GetCurrentUtcMillis();
+    const auto fetchMillis = endMillis > startMillis ? endMillis - startMillis : 1ULL;
+    const auto prevMillis = mFetchMillis.load();
 
-        const auto partNumber = i + 1;
-        const auto partOffset = fileSize + PART_SIZE_BYTE * i;
-        const auto partLength = min(PART_SIZE_BYTE, remaining);
+    mFetchMillis = prevMillis == 0 ? fetchMillis : (prevMillis * 3 + fetchMillis) / 4;
 
-        fileParts.emplace_back(std::make_shared<ReadFilePartType>(partNumber, partOffset, partLength, -1LL));
+    // 擾łp[g݂͈͑͂ƂċL^
+    // --> 擾ς͈̔͂ƏdȂ邱Ƃ̂ŁA𐔂
 
-        remaining -= partLength;
-    }
+    FILEIO_LENGTH_T addedBytes = 0;
 
-    if (fileParts.size() == 1)
+    const auto ntstatus = this->updateCacheExtents(CONT_CALLER argCacheFilePath, [&argFilePart, &addedBytes](CacheExtents* pExtents)
     {
-        const auto& filePart{ *fileParts.begin() };
-
-        // xőSēǂ߂Ă܂̂ŕGȂƂ͂Ȃ
+        const auto before = pExtents->presentBytes();
 
-        const auto readBytes = mDevice->getObjectAndWriteFile(START_CALLER objKey, filePath, filePart->mOffset, filePart->mLength);
+        pExtents->add(argFilePart->mOffset, argFilePart->mLength);
 
-        if (filePart->mLength != readBytes)
-        {
-            errorW(L"fault: getObjectAndWriteFile mLength=%lld readBytes=%lld", filePart->mLength, readBytes);
+        addedBytes = pExtents->presentBytes() - before;
+    });
 
-            return FspNtStatusFromWin32(ERROR_IO_DEVICE);
-        }
-    }
-    else
+    if (!NT_SUCCESS(ntstatus))
     {
-        // }`p[g̓ǂݍ݂x^XNɓo^
+        errorW(L"fault: updateCacheExtents argCacheFilePath=%s", argCacheFilePath.c_str());
+        return -1LL;
+    }
 
-        auto* const worker = this->getWorker(L"delayed");
+    // LbVt@C̍vTCŶŁAKvȂÂ̂폜
 
-        for (const auto& filePart: fileParts)
-        {
-            traceW(L"addTask filePart=%s", filePart->str().c_str());
+    if (addedBytes > 0)
+    {
+        this->scheduleEviction(mCacheIndex.addPresentBytes(argCacheFilePath, addedBytes));
+    }
 
-            worker->addTask(new ReadFilePartTask{ mDevice, objKey, filePath, filePart });
-        }
+    return readBytes;
+}
 
-        // ^XN̊ҋ@
+void CSDriver::completeFilePart(const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart, FILEIO_LENGTH_T argResult)
+{
+    // ̊֐ (ۗ Read ̉) I܂ł͎擾̃p[gƂĎc
+    // --> cancelInflightParts() ̊҂Ă悤
 
-        FILEIO_LENGTH_T sumReadBytes = 0;
+    argFilePart->setResult(argResult);
 
-        for (const auto& filePart: fileParts)
-        {
-            // p[gƂɓǂݎTCYWv
+    mInflightParts.remove(argCacheFilePath, argFilePart);
+}
 
-            const auto result = filePart->getResult();
+void CSDriver::addReadFilePartTask(const ObjectKey& argObjKey, const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart)
+{
+    // ܂ł͎擾̃p[gƂēo^
 
-            traceW(L"getResult filePart=%s result=%lld", filePart->str().c_str(), result);
+    mInflightParts.add(argCacheFilePath, argFilePart);
 
-            if (result != filePart->mLength)
-            {
-                sumReadBytes = -1LL;
+    this->getWorker(L"delayed")->addTask(new ReadFilePartTask{ this, argObjKey, argCacheFilePath, argFilePart });
+}
 
-                errorW(L"fault: mPartNumber=%d", filePart->mPartNumber);
-                break;
-            }
+NTSTATUS CSDriver::waitInflightParts(CALLER_ARG FileContext* ctx, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength)
+{
+    NEW_LOG_BLOCK();
 
-            sumReadBytes += result;
-        }
+    std::filesystem::path filePath;
 
-        if (sumReadBytes < requiredSizeBytes)
-        {
-            // }`p[g̈ꕔɃG[݂̂ŁASĂ̒x^XN𒆒fďI
+    if (!this->getCacheFilePath(ctx, &filePath))
+    {
+        const auto lerr = ::GetLastError();
 
-            errorW(L"The data is insufficient sumReadBytes=%lld", sumReadBytes);
+        errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+        return FspNtStatusFromWin32(lerr);
+    }
 
-            for (auto& filePart: fileParts)
-            {
-                // SẴp[gɒftO𗧂Ă
+    // ͈͂dȂp[g̃_E[hI܂ő҂
+    // --> 񂾓e[g̓eŏ㏑Ȃ悤
 
-                traceW(L"set mInterrupt mPartNumber=%lld", filePart->mPartNumber);
+    for (const auto& filePart: mInflightParts.find(filePath, argOffset, argLength))
+    {
+        traceW(L"wait filePart=%s", filePart->str().c_str());
 
-                filePart->mInterrupt = true;
+        filePart->getResult();
+    }
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS CSDriver::cancelInflightParts(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
+    std::filesystem::path filePath;
+
+    if (!this->getCacheFilePath(ctx, &filePath))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+        return FspNtStatusFromWin32(lerr);
+    }
+
+    // sÕp[g͒fAs̃p[g͊҂
+
+    const auto fileParts{ mInflightParts.findAll(filePath) };
+
+    for (const auto& filePart: fileParts)
+    {
+        filePart->mInterrupt = true;
+    }
+
+    for (const auto& filePart: fileParts)
+    {
+        traceW(L"wait filePart=%s", filePart->str().c_str());
+
+        filePart->getResult();
+    }
+
+    return STATUS_SUCCESS;
+}
+
+bool CSDriver::putObjectPartial(CALLER_ARG FileContext* ctx, const std::filesystem::path& argCacheFilePath)
+{
+    NEW_LOG_BLOCK();
+
+    const auto& dirEntry{ ctx->getDirEntry() };
+    const auto fileSize = static_cast<FILESIZE_T>(dirEntry->mFileInfo.FileSize);
+
+    // ύXO̓eςĂȂ͈͂擾
+
+    std::wstring baseETag;
+    std::list<CacheExtents::RangeType> cleanRanges;
+
+    if (!ctx->mDirtyRanges.getCleanRanges(fileSize, &baseETag, &cleanRanges))
+    {
+        traceW(L"not tracked ctx=%s", ctx->str().c_str());
+        return false;
+    }
+
+    // }`p[gEAbv[h̃p[g͍Ō̂̈ȊO͍ŏTCYȏłȂ΂ȂȂ̂ŁA
+    // ͈͂Ȃ΃Rs[͈͂ڂARs[͈͂ȂΑ͈͂Ɋ܂߂
+
+    const FILEIO_LENGTH_T MIN_PART_SIZE = FILESIZE_1MiBll * 5;
+
+    std::list<UploadRange> ranges;
+    FILEIO_LENGTH_T copyBytes = 0;
+    FILEIO_OFFSET_T pos = 0;
+
+    for (const auto& cleanRange: cleanRanges)
+    {
+        auto begin = cleanRange.first;
+        const auto end = cleanRange.first + cleanRange.second;
+
+        if (begin > pos && begin - pos < MIN_PART_SIZE)
+        {
+            begin = pos + MIN_PART_SIZE;
+        }
+
+        if (end - begin < MIN_PART_SIZE)
+        {
+            continue;
+        }
+
+        if (begin > pos)
+        {
+            ranges.push_back({ pos, begin - pos, false });
+        }
+
+        ranges.push_back({ begin, end - begin, true });
+
+        copyBytes += end - begin;
+        pos = end;
+    }
+
+    if (pos < fileSize)
+    {
+        ranges.push_back({ pos, fileSize - pos, false });
+    }
+
+    if (copyBytes == 0)
+    {
+        // Ŝ𑗂̂ƕςȂ
+
+        traceW(L"no range to copy ctx=%s", ctx->str().c_str());
+        return false;
+    }
+
+    // ͈͂A_E[h擾
+
+    for (const auto& range: ranges)
+    {
+        if (range.mCopy)
+        {
+            continue;
+        }
+
+        const auto ntstatus = this->syncContent(CONT_CALLER ctx, range.mOffset, range.mLength, nullptr);
+        if (!NT_SUCCESS(ntstatus))
+        {
+            errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
+            return false;
+        }
+    }
+
+    // [gύXO̓eXVĂΎŝŁAĂяoőŜAbv[h
+
+    const auto objKey{ ctx->getObjectKey() };
+
+    if (!mDevice->putObjectPartial(CONT_CALLER objKey, dirEntry->mFileInfo, argCacheFilePath.c_str(), baseETag, ranges))
+    {
+        traceW(L"fault: putObjectPartial objKey=%s", objKey.c_str());
+        return false;
+    }
+
+    traceW(L"success: putObjectPartial fileSize=%lld copyBytes=%lld", fileSize, copyBytes);
+
+    return true;
+}
+
+void CSDriver::beginStreamUpload(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
+    if (!mRuntimeEnv->StreamUpload || ctx->getDirEntry()->mFileType != FileTypeEnum::File)
+    {
+        return;
+    }
+
+    std::filesystem::path cacheFilePath;
+
+    if (!GetFileNameFromHandle(ctx->getHandle(), &cacheFilePath))
+    {
+        errorW(L"fault: GetFileNameFromHandle ctx=%s", ctx->str().c_str());
+        return;
+    }
+
+    // foCXΉĂȂ΁AN[YɑŜAbv[h
+
+    auto upload{ mDevice->beginStreamUpload(CONT_CALLER ctx->getObjectKey(), ctx->getDirEntry()->mFileInfo, cacheFilePath.c_str()) };
+    if (!upload)
+    {
+        traceW(L"not supported ctx=%s", ctx->str().c_str());
+        return;
+    }
+
+    // ɂ͓̂euꂽ̂ŁAjĒf
+
+    ctx->mStreamUpload = std::make_shared<StreamUpload>(std::move(upload));
+
+    std::shared_ptr<StreamUpload> other;
+
+    {
+        std::lock_guard<std::mutex> lock_{ mStreamUploadGuard };
+
+        auto& weak{ mStreamUploads[ctx->getWinPath()] };
+
+        other = weak.lock();
+        weak = ctx->mStreamUpload;
+    }
+
+    if (other)
+    {
+        traceW(L"cancel other ctx=%s", ctx->str().c_str());
+        other->cancel();
+    }
+}
+
+void CSDriver::cancelOtherStreamUpload(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
+    // ̃nhŏ݂ƕsăAbv[hĂ΁AMς̓eƕς\̂Œf
+
+    std::shared_ptr<StreamUpload> other;
+
+    {
+        std::lock_guard<std::mutex> lock_{ mStreamUploadGuard };
+
+        const auto it{ mStreamUploads.find(ctx->getWinPath()) };
+        if (it == mStreamUploads.cend())
+        {
+            return;
+        }
+
+        other = it->second.lock();
+        if (other == ctx->mStreamUpload)
+        {
+            return;
+        }
+    }
+
+    if (other)
+    {
+        traceW(L"cancel other ctx=%s", ctx->str().c_str());
+        other->cancel();
+    }
+}
+
+void CSDriver::endStreamUpload(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
+    if (!ctx->mStreamUpload)
+    {
+        return;
+    }
+
+    traceW(L"ctx=%s", ctx->str().c_str());
+
+    {
+        std::lock_guard<std::mutex> lock_{ mStreamUploadGuard };
+
+        const auto it{ mStreamUploads.find(ctx->getWinPath()) };
+        if (it != mStreamUploads.cend())
+        {
+            const auto current{ it->second.lock() };
+
+            if (!current || current == ctx->mStreamUpload)
+            {
+                mStreamUploads.erase(it);
+            }
+        }
+    }
+
+    // ĂȂ΁Ajɂ蒆f
+
+    ctx->mStreamUpload.reset();
+}
+
+bool CSDriver::completeStreamUpload(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
+    if (!ctx->mStreamUpload)
+    {
+        return false;
+    }
+
+    const auto upload{ ctx->mStreamUpload->release() };
+    if (!upload)
+    {
+        traceW(L"cancelled ctx=%s", ctx->str().c_str());
+        return false;
+    }
+
+    // Mς̃p[gɑĎc𑗂A}`p[gEAbv[h
+
+    const auto objKey{ ctx->getObjectKey() };
+
+    if (!mDevice->completeStreamUpload(CONT_CALLER objKey, upload.get(), ctx->getDirEntry()->mFileInfo))
+    {
+        errorW(L"fault: completeStreamUpload objKey=%s", objKey.c_str());
+        return false;
+    }
+
+    traceW(L"success: completeStreamUpload objKey=%s", objKey.c_str());
+
+    return true;
+}
+
+bool CSDriver::rebindCacheFile(CALLER_ARG FileContext* ctx, const std::wstring& argETag, std::filesystem::path* pNewCacheFilePath)
+{
+    NEW_LOG_BLOCK();
+
+    std::filesystem::path cacheFilePath;
+
+    if (!GetFileNameFromHandle(ctx->getHandle(), &cacheFilePath))
+    {
+        errorW(L"fault: GetFileNameFromHandle ctx=%s", ctx->str().c_str());
+        return false;
+    }
+
+    const auto& refWinPath{ ctx->getWinPath() };
+
+    std::filesystem::path newCacheFilePath;
+
+    if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, refWinPath, argETag, &newCacheFilePath))
+    {
+        errorW(L"fault: resolveCacheFilePath refWinPath=%s", refWinPath.c_str());
+        return false;
+    }
+
+    // ړÕpXɏރp[gcȂ悤
+
+    auto ntstatus = this->cancelInflightParts(CONT_CALLER ctx);
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: cancelInflightParts ctx=%s", ctx->str().c_str());
+        return false;
+    }
+
+    // LbVɑ݂e̓Abv[ĥƈvĂ
+    // --> UploadPartCopy ŃRs[͈͂̓_E[hĂȂ\̂ŁA
+    //     擾ς͈̔͂͂̂܂܎cAETag ւ
+
+    const auto fileSize = ctx->getDirEntry()->mFileInfo.FileSize;
+    FILEIO_LENGTH_T presentBytes = 0;
+
+    ntstatus = this->updateCacheExtents(CONT_CALLER cacheFilePath, [fileSize, &argETag, &presentBytes](CacheExtents* pExtents)
+    {
+        pExtents->rebind(fileSize, argETag);
+        presentBytes = pExtents->presentBytes();
+    });
+
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: updateCacheExtents cacheFilePath=%s", cacheFilePath.c_str());
+        return false;
+    }
+
+    if (newCacheFilePath.filename() != cacheFilePath.filename())
+    {
+        traceW(L"MoveFileExW cacheFilePath=%s, newCacheFilePath=%s", cacheFilePath.c_str(), newCacheFilePath.c_str());
+
+        if (!::MoveFileExW(cacheFilePath.c_str(), newCacheFilePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+        {
+            const auto lerr = ::GetLastError();
+            errorW(L"fault: MoveFileExW lerr=%lu cacheFilePath=%s, newCacheFilePath=%s", lerr, cacheFilePath.c_str(), newCacheFilePath.c_str());
+
+            return false;
+        }
+
+        // nhɑΉpXς
+
+        mCacheStateEpoch++;
+    }
+
+    mCacheIndex.set(refWinPath, newCacheFilePath, argETag, fileSize);
+    mCacheIndex.touch(refWinPath, presentBytes);
+
+    if (!argETag.empty())
+    {
+        ctx->getDirEntry()->mUserProperties[L"wincse-etag"] = argETag;
+    }
+
+    *pNewCacheFilePath = std::move(newCacheFilePath);
+
+    return true;
+}
+
+bool CSDriver::readWithMappedView(CALLER_ARG FileContext* ctx, PVOID argBuffer, FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred)
+{
+    NEW_LOG_BLOCK();
+
+    const auto& dirEntry{ ctx->getDirEntry() };
+    const auto& refWinPath{ ctx->getWinPath() };
+    const auto fileSize = static_cast<FILEIO_OFFSET_T>(dirEntry->mFileInfo.FileSize);
+
+    APP_ASSERT(argOffset < fileSize);
+
+    const auto version{ getContentVersion(dirEntry) };
+
+    auto view{ mMappedViews.get(refWinPath, version) };
+    if (!view)
+    {
+        // őŜĂȂƂA͈͏mFă}bv
+        // --> ꕔLbVĂȂt@Cւ Read Ƃɔ͈͏ǂ܂Ȃ悤
+
+        CacheIndex::Entry entry;
+
+        if (!mCacheIndex.get(refWinPath, &entry) || entry.mPresentBytes < fileSize)
+        {
+            return false;
+        }
+
+        std::filesystem::path filePath;
+
+        if (!this->getCacheFilePath(ctx, &filePath))
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+            return false;
+        }
+
+        CacheExtents extents;
+
+        if (!this->loadCacheExtents(filePath, &extents))
+        {
+            errorW(L"fault: load filePath=%s", filePath.c_str());
+            return false;
+        }
+
+        if (extents.getRemoteSize() != fileSize || !extents.contains(0, fileSize))
+        {
+            traceW(L"not fully cached extents=%s", extents.str().c_str());
+            return false;
+        }
+
+        view = mMappedViews.map(refWinPath, version, ctx->getWritableHandle(), fileSize);
+        if (!view)
+        {
+            return false;
+        }
+    }
+
+    if (view->mSize != fileSize)
+    {
+        mMappedViews.invalidate(refWinPath);
+        return false;
+    }
+
+    const auto length = static_cast<ULONG>(min(fileSize - argOffset, static_cast<FILEIO_OFFSET_T>(argLength)));
+
+    if (!MappedViews::copy(*view, argOffset, length, argBuffer))
+    {
+        errorW(L"fault: copy argOffset=%lld length=%lu ctx=%s", argOffset, length, ctx->str().c_str());
+
+        // ȍ~ ReadFile œǂ
+
+        mMappedViews.invalidate(refWinPath);
+        return false;
+    }
+
+    *argBytesTransferred = length;
+
+    return true;
+}
+
+NTSTATUS CSDriver::readWithBlockCache(CALLER_ARG FileContext* ctx, PVOID argBuffer, FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred, bool* pDownloaded, std::list<std::shared_ptr<ReadFilePartType>>* pPendingParts)
+{
+    NEW_LOG_BLOCK();
+
+    const auto& dirEntry{ ctx->getDirEntry() };
+    const auto& refWinPath{ ctx->getWinPath() };
+    const auto fileSize = static_cast<FILEIO_OFFSET_T>(dirEntry->mFileInfo.FileSize);
+
+    APP_ASSERT(argOffset < fileSize);
+
+    const auto length = static_cast<ULONG>(min(fileSize - argOffset, static_cast<FILEIO_OFFSET_T>(argLength)));
+    const auto version{ getContentVersion(dirEntry) };
+
+    if (mBlockCache.get(refWinPath, version, argOffset, length, argBuffer))
+    {
+        traceW(L"hit: argOffset=%lld length=%lu", argOffset, length);
+
+        *argBytesTransferred = length;
+
+        return STATUS_SUCCESS;
+    }
+
+    // ubNPʂŃLbVt@Cǂ݁Aɕێ
+    // --> 擾҂KvƂ STATUS_PENDING ԂAĂяo Read ۗ
+    //     (ubN͎ Read ŃLbVt@Cǂ܂)
+
+    const auto blockBegin = argOffset / BlockCache::BLOCK_SIZE * BlockCache::BLOCK_SIZE;
+    const auto blockEnd = min(ALIGN_TO_UNIT(argOffset + length, BlockCache::BLOCK_SIZE), fileSize);
+
+    const auto ntstatus = this->syncContent(CONT_CALLER ctx, blockBegin, blockEnd - blockBegin, pDownloaded, pPendingParts);
+    if (ntstatus == STATUS_PENDING)
+    {
+        traceW(L"pending: blockBegin=%lld blockEnd=%lld", blockBegin, blockEnd);
+        return ntstatus;
+    }
+
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
+        return ntstatus;
+    }
+
+    std::vector<BYTE> buffer(static_cast<size_t>(blockEnd - blockBegin));
+
+    OVERLAPPED Overlapped{};
+
+    Overlapped.Offset     = static_cast<DWORD>(blockBegin);
+    Overlapped.OffsetHigh = static_cast<DWORD>(blockBegin >> 32);
+
+    traceW(L"ReadFile blockBegin=%lld blockEnd=%lld", blockBegin, blockEnd);
+
+    DWORD bytesRead = 0;
+
+    if (!::ReadFile(ctx->getWritableHandle(), buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, &Overlapped))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: ReadFile lerr=%lu ctx=%s", lerr, ctx->str().c_str());
+        return FspNtStatusFromWin32(lerr);
+    }
+
+    for (FILEIO_OFFSET_T pos=0; pos<bytesRead; pos+=BlockCache::BLOCK_SIZE)
+    {
+        const auto blockLength = min(static_cast<FILEIO_OFFSET_T>(bytesRead) - pos, BlockCache::BLOCK_SIZE);
+
+        mBlockCache.put(refWinPath, version, (blockBegin + pos) / BlockCache::BLOCK_SIZE, buffer.data() + pos, static_cast<ULONG>(blockLength));
+    }
+
+    const auto skip = argOffset - blockBegin;
+
+    if (bytesRead <= skip)
+    {
+        traceW(L"EOF");
+        return FspNtStatusFromWin32(ERROR_HANDLE_EOF);
+    }
+
+    const auto copyLength = static_cast<ULONG>(min(static_cast<FILEIO_OFFSET_T>(bytesRead) - skip, static_cast<FILEIO_OFFSET_T>(length)));
+
+    memcpy(argBuffer, buffer.data() + skip, copyLength);
+
+    *argBytesTransferred = copyLength;
+
+    return STATUS_SUCCESS;
+}
+
+bool CSDriver::canStreamRead(FileContext* ctx, FILEIO_OFFSET_T argOffset)
+{
+    if (mRuntimeEnv->StreamReadMinSizeMib <= 0)
+    {
+        return false;
+    }
+
+    if (ctx->mFlags & FCTX_FLAGS_MODIFY)
+    {
+        // [J̕ύX̓LbVt@CɂȂ
+
+        return false;
+    }
+
+    const auto fileSize = static_cast<FILEIO_OFFSET_T>(ctx->getDirEntry()->mFileInfo.FileSize);
+
+    if (fileSize <= argOffset)
+    {
+        return false;
+    }
+
+    const auto PART_SIZE_BYTE = mReadTuner.getPartSize();
+
+    if (fileSize < FILESIZE_1MiBll * mRuntimeEnv->StreamReadMinSizeMib)
+    {
+        // ȃt@Cł FILE_SEQUENTIAL_ONLY ŊJĂΑΏۂɂ
+        // --> 1 p[gɎ܂̂̓LbVt@CoR
+
+        if (!ctx->mStreamRead.isSequentialOnly() || fileSize <= PART_SIZE_BYTE)
+        {
+            return false;
+        }
+    }
+
+    if (!ctx->mStreamRead.isActive())
+    {
+        // LbVt@CɎ擾ς̓e΁Ag
+
+        CacheIndex::Entry entry;
+
+        if (mCacheIndex.get(ctx->getWinPath(), &entry) && entry.mPresentBytes > 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+NTSTATUS CSDriver::readWithStream(CALLER_ARG FileContext* ctx, PVOID argBuffer, FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred)
+{
+    NEW_LOG_BLOCK();
+
+    const auto fileSize = static_cast<FILEIO_OFFSET_T>(ctx->getDirEntry()->mFileInfo.FileSize);
+    APP_ASSERT(argOffset < fileSize);
+
+    const auto PART_SIZE_BYTE = mReadTuner.getPartSize();
+
+    const auto readLength = min(static_cast<FILEIO_LENGTH_T>(argLength), fileSize - argOffset);
+    const auto readEnd = argOffset + readLength;
+
+    const auto& objKey{ ctx->getObjectKey() };
+
+    // I[v_̔ł̓e󂯎
+    // --> rŃ[gXVꂽƂɁAقȂł̓e݂Ȃ悤
+
+    const auto etag{ getDirEntryETag(ctx->getDirEntry()) };
+
+    // Read ͈̔͂ƁA̐̃p[g̎擾o^
+
+    for (const auto& filePart: ctx->mStreamRead.fill(readEnd, fileSize, PART_SIZE_BYTE, mRuntimeEnv->StreamReadRingParts))
+    {
+        traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+        this->addStreamFilePartTask(objKey, etag, filePart);
+    }
+
+    // 擾p[g Read ̃obt@ɃRs[
+
+    const auto bytesRead = ctx->mStreamRead.read(argOffset, argBuffer, readLength);
+    if (bytesRead != readLength)
+    {
+        errorW(L"fault: read readLength=%lld bytesRead=%lld ctx=%s", readLength, bytesRead, ctx->str().c_str());
+        return FspNtStatusFromWin32(ERROR_IO_DEVICE);
+    }
+
+    // p[g̕Ãp[go^
+
+    for (const auto& filePart: ctx->mStreamRead.fill(readEnd, fileSize, PART_SIZE_BYTE, mRuntimeEnv->StreamReadRingParts))
+    {
+        traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+        this->addStreamFilePartTask(objKey, etag, filePart);
+    }
+
+    traceW(L"mStreamRead=%s", ctx->mStreamRead.str().c_str());
+
+    *argBytesTransferred = static_cast<ULONG>(bytesRead);
+
+    return STATUS_SUCCESS;
+}
+
+void CSDriver::addStreamFilePartTask(const ObjectKey& argObjKey, const std::wstring& argETag, const std::shared_ptr<StreamFilePart>& argFilePart)
+{
+    // LbVt@Cɂ͏܂Ȃ̂ŁA擾̃p[gƂĂ͓o^Ȃ
+
+    this->getWorker(L"delayed")->addTask(new StreamFilePartTask{ this, argObjKey, argETag, argFilePart });
+}
+
+FILEIO_LENGTH_T CSDriver::streamFilePart(CALLER_ARG const ObjectKey& argObjKey, const std::wstring& argETag, const std::shared_ptr<StreamFilePart>& argFilePart)
+{
+    NEW_LOG_BLOCK();
+
+    if (argFilePart->mInterrupt)
+    {
+        traceW(L"Interruption request received filePart=%s", argFilePart->str().c_str());
+        return -1LL;
+    }
+
+    TransferTuner::Slot slot{ &mReadTuner };
+
+    const auto readBytes = mDevice->getObjectAndWriteBuffer(CONT_CALLER argObjKey, argFilePart->mBuffer.data(), argFilePart->mOffset, argFilePart->mLength, argETag);
+
+    if (readBytes == FILEIO_LENGTH_ETAG_MISMATCH)
+    {
+        // I[vɃ[gXVꂽ
+        // --> foCX̃LbV͔jĂ̂ŁAJΐVeǂ߂
+
+        errorW(L"fault: remote modified argObjKey=%s argETag=%s filePart=%s", argObjKey.c_str(), argETag.c_str(), argFilePart->str().c_str());
+        return -1LL;
+    }
+
+    if (readBytes != argFilePart->mLength)
+    {
+        errorW(L"fault: getObjectAndWriteBuffer mLength=%lld readBytes=%lld", argFilePart->mLength, readBytes);
+        return -1LL;
+    }
+
+    slot.complete(readBytes);
+
+    return readBytes;
+}
+
+void CSDriver::readAhead(CALLER_ARG FileContext* ctx, FILEIO_OFFSET_T argReadOffset, FILEIO_LENGTH_T argReadLength, bool argDownloaded)
+{
+    NEW_LOG_BLOCK();
+
+    if (mRuntimeEnv->ReadAheadMaxParts <= 0)
+    {
+        return;
+    }
+
+    const auto PART_SIZE_BYTE = mReadTuner.getPartSize();
+
+    // A Read ł΁Aǂ݂͈͂擾
+
+    FILEIO_OFFSET_T aheadBegin = 0LL;
+    FILEIO_OFFSET_T aheadEnd = 0LL;
+
+    if (!ctx->mReadAhead.next(argReadOffset, argReadLength, argDownloaded,
+        PART_SIZE_BYTE, mRuntimeEnv->ReadAheadMaxParts, mFetchMillis.load(), &aheadBegin, &aheadEnd))
+    {
+        return;
+    }
+
+    traceW(L"aheadBegin=%lld aheadEnd=%lld mReadAhead=%s", aheadBegin, aheadEnd, ctx->mReadAhead.str().c_str());
+
+    std::filesystem::path filePath;
+
+    if (!this->getCacheFilePath(ctx, &filePath))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+        return;
+    }
+
+    CacheExtents extents;
+
+    if (!this->loadCacheExtents(filePath, &extents))
+    {
+        errorW(L"fault: load filePath=%s", filePath.c_str());
+        return;
+    }
+
+    // Read ̏I[ǂ݂̏I[܂ł݂̑Ȃ擾
+    // --> fꂽǂ݂΁Aōēo^
+
+    const auto readEnd = argReadOffset + argReadLength;
+
+    if (readEnd >= aheadEnd)
+    {
+        return;
+    }
+
+    const auto& objKey{ ctx->getObjectKey() };
+
+    auto holes{ extents.missing(readEnd, aheadEnd - readEnd) };
+
+    if (!extents.getETag().empty())
+    {
+        // syncContent ƓA߂͈͂͂܂Ƃ߂Ď擾
+
+        holes = CacheExtents::coalesce(holes, mReadTuner.getBridgeBytes());
+    }
+
+    int partNumber = 0;
+
+    for (const auto& hole: holes)
+    {
+        const auto holeEnd = hole.first + hole.second;
+
+        for (auto partOffset = hole.first; partOffset < holeEnd; )
+        {
+            const auto partEnd = min((partOffset / PART_SIZE_BYTE + 1) * PART_SIZE_BYTE, holeEnd);
+
+            // ̃nhȂǂŎ擾͈̔͂͏
+
+            if (mInflightParts.find(filePath, partOffset, partEnd - partOffset).empty())
+            {
+                const auto filePart{ std::make_shared<ReadFilePartType>(++partNumber, partOffset, partEnd - partOffset, -1LL) };
+
+                traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+                ctx->mReadAhead.addFilePart(filePart);
+
+                this->addReadFilePartTask(objKey, filePath, filePart);
+            }
+
+            partOffset = partEnd;
+        }
+    }
+}
+
+void CSDriver::prefetchHeadTail(CALLER_ARG FileContext* ctx)
+{
+    NEW_LOG_BLOCK();
+
+    if (mRuntimeEnv->HeadTailPrefetchKib <= 0 || !hasTrailingIndex(ctx->getWinPath()))
+    {
+        return;
+    }
+
+    std::filesystem::path filePath;
+
+    if (!this->getCacheFilePath(ctx, &filePath))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+        return;
+    }
+
+    CacheExtents extents;
+
+    if (!this->loadCacheExtents(filePath, &extents))
+    {
+        errorW(L"fault: load filePath=%s", filePath.c_str());
+        return;
+    }
+
+    if (extents.getETag().empty())
+    {
+        // [JŕύXꂽ̂͑ΏۊO
+
+        traceW(L"modified filePath=%s", filePath.c_str());
+        return;
+    }
+
+    // 擪Ɩ͈̔ (t@C͑S)
+
+    const auto remoteSize = extents.getRemoteSize();
+    const auto edgeBytes = min(FILESIZE_1KiBll * mRuntimeEnv->HeadTailPrefetchKib, remoteSize);
+
+    std::list<CacheExtents::RangeType> ranges;
+
+    if (remoteSize <= edgeBytes * 2)
+    {
+        ranges.emplace_back(0LL, remoteSize);
+    }
+    else
+    {
+        ranges.emplace_back(0LL, edgeBytes);
+        ranges.emplace_back(remoteSize - edgeBytes, edgeBytes);
+    }
+
+    const auto& objKey{ ctx->getObjectKey() };
+
+    int partNumber = 0;
+
+    for (const auto& range: ranges)
+    {
+        for (const auto& hole: extents.missing(range.first, range.second))
+        {
+            // ̃nhȂǂŎ擾͈̔͂͏
+
+            if (!mInflightParts.find(filePath, hole.first, hole.second).empty())
+            {
+                continue;
+            }
+
+            const auto filePart{ std::make_shared<ReadFilePartType>(++partNumber, hole.first, hole.second, -1LL) };
+
+            traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+            // Cleanup  Close Œfł悤ɁAt@CEReLXgɓo^Ă
+
+            ctx->mReadAhead.addFilePart(filePart);
+
+            this->addReadFilePartTask(objKey, filePath, filePart);
+        }
+    }
+}
+
+NTSTATUS CSDriver::syncContent(CALLER_ARG FileContext* ctx, FILEIO_OFFSET_T argReadOffset, FILEIO_LENGTH_T argReadLength, bool* pDownloaded, std::list<std::shared_ptr<ReadFilePartType>>* pPendingParts)
+{
+    NEW_LOG_BLOCK();
+
+    traceW(L"ctx=%s argReadOffset=%lld argReadLength=%lld", ctx->str().c_str(), argReadOffset, argReadLength);
+
+    if (argReadLength == 0)
+    {
+        traceW(L"Empty read");
+        return STATUS_SUCCESS;
+    }
+
+    const auto& fileInfo{ ctx->getDirEntry()->mFileInfo };
+
+    if (fileInfo.FileSize == 0)
+    {
+        traceW(L"Empty content");
+        return STATUS_SUCCESS;
+    }
+
+    // Oǂݍ񂾔͈͏őĂ΁ALbVt@Cɂ̓ANZXȂ
+
+    const auto epoch = mCacheStateEpoch.load();
+
+    if (ctx->mCacheState.contains(epoch, argReadOffset, argReadLength))
+    {
+        traceW(L"Download not required (cached state)");
+        return STATUS_SUCCESS;
+    }
+
+    // t@CEnh烍[J̃t@C擾
+
+    std::filesystem::path filePath;
+
+    if (!this->getCacheFilePath(ctx, &filePath))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+        return FspNtStatusFromWin32(lerr);
+    }
+
+    traceW(L"filePath=%s", filePath.c_str());
+
+    // LbVt@Cɑ݂͈͂擾
+
+    CacheExtents extents;
+
+    if (!this->loadCacheExtents(filePath, &extents))
+    {
+        errorW(L"fault: load filePath=%s", filePath.c_str());
+        return FspNtStatusFromWin32(ERROR_IO_DEVICE);
+    }
+
+    traceW(L"extents=%s", extents.str().c_str());
+
+    ctx->mCacheState.setExtents(epoch, extents);
+
+    // Read ͈͂̂A[g擾Kv̂镔
+    // 
+    // --> [g̃TCYȍ~̓[Jō쐬 (Write, SetFileSize) ꂽ
+
+    const auto remoteSize = extents.getRemoteSize();
+    const auto readEnd = min(argReadOffset + argReadLength, remoteSize);
+
+    if (readEnd <= argReadOffset || extents.contains(argReadOffset, readEnd - argReadOffset))
+    {
+        // Read ͈͂̃f[^݂͑̂ OK
+
+        traceW(L"Download not required");
+        return STATUS_SUCCESS;
+    }
+
+    traceW(L"readEnd=%lld", readEnd);
+
+    // }`p[ĝ̃p[gTCY
+
+#if 0
+    traceW(L"!!");
+    traceW(L"!! WARNING: PART SIZE !!");
+    traceW(L"!!");
+
+    const auto PART_SIZE_BYTE = ILESIZE_1Bll * 10;
+
+#else
+    auto PART_SIZE_BYTE = mReadTuner.getPartSize();
+
+    if (argReadOffset == 0 && readEnd <= FILESIZE_1MiBll)
+    {
+        // GNXv[ŃvpeBJƃ^f[^ǂݎ邱ƂɑΉ
+        // --> 擪 1MiB ܂ł Read ̏ꍇ̓p[gTCY 1MiB ɐݒ
+
+        PART_SIZE_BYTE = FILESIZE_1MiBll;
+    }
+
+#endif
+    traceW(L"PART_SIZE_BYTE=%lld", PART_SIZE_BYTE);
+
+    const auto& objKey{ ctx->getObjectKey() };
+
+    // p[gTCY̋EɊg͈͂̂A݂Ȃ݂̂擾
+
+    const auto alignedBegin = argReadOffset / PART_SIZE_BYTE * PART_SIZE_BYTE;
+    const auto alignedEnd = min(ALIGN_TO_UNIT(readEnd, PART_SIZE_BYTE), remoteSize);
+
+    // eϐ̒l̊֌W
+    // 
+    // [alignedBegin] <= [argReadOffset] < [readEnd] <= [alignedEnd] <= [remoteSize]
+
+    APP_ASSERT(alignedBegin <= argReadOffset);
+    APP_ASSERT(readEnd <= alignedEnd);
+
+    auto holes{ extents.missing(alignedBegin, alignedEnd - alignedBegin) };
+    APP_ASSERT(!holes.empty());
+
+    if (!extents.getETag().empty())
+    {
+        // 擾ς̕ޔ͈͂́AԂ擾v𕪂葁΂܂Ƃ߂
+        // --> 擾ς̕㏑̂ŁA[JŕύXĂȂƂ̂
+
+        holes = CacheExtents::coalesce(holes, mReadTuner.getBridgeBytes());
+
+        traceW(L"coalesce holes.size=%zu", holes.size());
+    }
+
+    // ̃nhǂ݂Ŏ擾̃p[gƏdȂ͈͂́AVɎ擾Ɋ҂
+    // --> t@C̃R[obN̓bNĂ̂ŁAmFo^܂ł̊Ԃ
+    //     擾̃p[gǉ邱Ƃ͂Ȃ
+
+    auto inflightParts{ mInflightParts.find(filePath, alignedBegin, alignedEnd - alignedBegin) };
+
+    inflightParts.sort([](const auto& lhs, const auto& rhs)
+    {
+        return lhs->mOffset < rhs->mOffset;
+    });
+
+    std::list<CacheExtents::RangeType> ranges;
+
+    for (const auto& hole: holes)
+    {
+        const auto holeEnd = hole.first + hole.second;
+        auto pos = hole.first;
+
+        for (const auto& inflightPart: inflightParts)
+        {
+            const auto inflightEnd = inflightPart->mOffset + inflightPart->mLength;
+
+            if (inflightEnd <= pos || holeEnd <= inflightPart->mOffset)
+            {
+                continue;
+            }
+
+            if (pos < inflightPart->mOffset)
+            {
+                ranges.emplace_back(pos, inflightPart->mOffset - pos);
+            }
+
+            pos = max(pos, inflightEnd);
+        }
+
+        if (pos < holeEnd)
+        {
+            ranges.emplace_back(pos, holeEnd - pos);
+        }
+    }
+
+    std::list<std::shared_ptr<ReadFilePartType>> joinParts;
+
+    for (const auto& inflightPart: inflightParts)
+    {
+        if (inflightPart->mOffset < readEnd && argReadOffset < inflightPart->mOffset + inflightPart->mLength)
+        {
+            traceW(L"join filePart=%s", inflightPart->str().c_str());
+
+            joinParts.push_back(inflightPart);
+        }
+    }
+
+    // 擾̈쐬
+
+    std::list<std::shared_ptr<ReadFilePartType>> fileParts;
+
+    int partNumber = 0;
+
+    for (const auto& range: ranges)
+    {
+        const auto rangeEnd = range.first + range.second;
+
+        for (auto partOffset = range.first; partOffset < rangeEnd; )
+        {
+            // p[g̋Eŕ FilePart 쐬
+
+            const auto partEnd = min((partOffset / PART_SIZE_BYTE + 1) * PART_SIZE_BYTE, rangeEnd);
+
+            fileParts.emplace_back(std::make_shared<ReadFilePartType>(++partNumber, partOffset, partEnd - partOffset, -1LL));
+
+            partOffset = partEnd;
+        }
+    }
+
+    // Read ͈͂ƏdȂp[ĝ݊҂Ap[g̋EɊg̓obNOEhŎ擾
+    // --> g Close őҋ@ł悤ɁAt@CEReLXgɓo^Ă
+
+    std::list<std::shared_ptr<ReadFilePartType>> waitParts;
+
+    for (const auto& filePart: fileParts)
+    {
+        if (filePart->mOffset < readEnd && argReadOffset < filePart->mOffset + filePart->mLength)
+        {
+            waitParts.push_back(filePart);
+        }
+        else
+        {
+            traceW(L"addTask(background) filePart=%s", filePart->str().c_str());
+
+            ctx->mReadAhead.addFilePart(filePart);
+
+            this->addReadFilePartTask(objKey, filePath, filePart);
+        }
+    }
+
+    APP_ASSERT(!waitParts.empty() || !joinParts.empty());
+
+    if (pDownloaded)
+    {
+        *pDownloaded = true;
+    }
+
+    if (pPendingParts)
+    {
+        // ҂ɖ߂AĂяop[g̊󂯎
+
+        for (const auto& filePart: waitParts)
+        {
+            traceW(L"addTask(pending) filePart=%s", filePart->str().c_str());
+
+            this->addReadFilePartTask(objKey, filePath, filePart);
+        }
+
+        pPendingParts->insert(pPendingParts->end(), waitParts.cbegin(), waitParts.cend());
+        pPendingParts->insert(pPendingParts->end(), joinParts.cbegin(), joinParts.cend());
+
+        return STATUS_PENDING;
+    }
+
+    NTSTATUS ntstatus = STATUS_SUCCESS;
+
+    if (waitParts.size() == 1)
+    {
+        const auto& filePart{ *waitParts.begin() };
+
+        // xőSēǂ߂Ă܂̂ŕGȂƂ͂Ȃ
+        // -->  Read ǂ݂猩悤ɁA擾̃p[gƂēo^
+
+        mInflightParts.add(filePath, filePart);
+
+        const auto readBytes = this->readFilePart(CONT_CALLER objKey, filePath, filePart);
+
+        this->completeFilePart(filePath, filePart, readBytes);
+
+        if (filePart->mLength != readBytes)
+        {
+            errorW(L"fault: readFilePart mLength=%lld readBytes=%lld", filePart->mLength, readBytes);
+
+            ntstatus = FspNtStatusFromWin32(ERROR_IO_DEVICE);
+        }
+    }
+    else
+    {
+        // }`p[g̓ǂݍ݂x^XNɓo^
+
+        for (const auto& filePart: waitParts)
+        {
+            traceW(L"addTask filePart=%s", filePart->str().c_str());
+
+            this->addReadFilePartTask(objKey, filePath, filePart);
+        }
+
+        // ^XN̊ҋ@
+
+        for (const auto& filePart: waitParts)
+        {
+            const auto result = filePart->getResult();
+
+            traceW(L"getResult filePart=%s result=%lld", filePart->str().c_str(), result);
+
+            if (result == filePart->mLength)
+            {
+                // 擾łp[g readFilePart Ŕ͈͏ɋL^Ă
+
+                continue;
             }
 
-            for (auto& filePart: fileParts)
+            errorW(L"fault: mPartNumber=%d", filePart->mPartNumber);
+
+            if (NT_SUCCESS(ntstatus))
             {
-                // ^XN̊ҋ@
+                // }`p[g̈ꕔɃG[݂̂ŁASĂ̒x^XN𒆒f
 
-                const auto result = filePart->getResult();
-                if (result != filePart->mLength)
+                for (auto& it: waitParts)
                 {
-                    errorW(L"fault: mPartNumber=%d", filePart->mPartNumber);
+                    traceW(L"set mInterrupt mPartNumber=%lld", it->mPartNumber);
+
+                    it->mInterrupt = true;
                 }
+
+                ntstatus = FspNtStatusFromWin32(ERROR_IO_DEVICE);
             }
+        }
+    }
+
+    // Ŏ擾p[g̊ҋ@
+
+    for (const auto& filePart: joinParts)
+    {
+        const auto result = filePart->getResult();
+
+        traceW(L"getResult(join) filePart=%s result=%lld", filePart->str().c_str(), result);
+
+        if (result == filePart->mLength || !NT_SUCCESS(ntstatus))
+        {
+            continue;
+        }
+
+        // ǂ݂̒fȂǂŎ擾ȂƂ́AgŎ擾
+
+        const auto retryPart{ std::make_shared<ReadFilePartType>(++partNumber, filePart->mOffset, filePart->mLength, -1LL) };
+
+        const auto readBytes = this->readFilePart(CONT_CALLER objKey, filePath, retryPart);
+
+        if (retryPart->mLength != readBytes)
+        {
+            errorW(L"fault: readFilePart mLength=%lld readBytes=%lld", retryPart->mLength, readBytes);
 
-            traceW(L"error exists");
-            return FspNtStatusFromWin32(ERROR_IO_DEVICE);
+            ntstatus = FspNtStatusFromWin32(ERROR_IO_DEVICE);
         }
     }
 
@@ -495,10 +1879,430 @@ NTSTATUS CSDriver::syncContent(CALLER_ARG FileContext* ctx, FILEIO_OFFSET_T argR
         return FspNtStatusFromWin32(lerr);
     }
 
+    if (!NT_SUCCESS(ntstatus))
+    {
+        traceW(L"error exists");
+        return ntstatus;
+    }
+
     return STATUS_SUCCESS;
 
 }   // syncContent
 
+NTSTATUS CSDriver::readCacheFile(CALLER_ARG FileContext* ctx, PVOID argBuffer, FILEIO_OFFSET_T argOffset, ULONG argLength, PULONG argBytesTransferred)
+{
+    NEW_LOG_BLOCK();
+
+    HANDLE Handle = ctx->getWritableHandle();
+
+    OVERLAPPED Overlapped{};
+
+    Overlapped.Offset     = static_cast<DWORD>(argOffset);
+    Overlapped.OffsetHigh = static_cast<DWORD>(argOffset >> 32);
+
+    traceW(L"ReadFile argOffset=%lld argLength=%lu", argOffset, argLength);
+
+    if (!::ReadFile(Handle, argBuffer, argLength, argBytesTransferred, &Overlapped))
+    {
+        const auto lerr = ::GetLastError();
+
+        if (lerr == ERROR_HANDLE_EOF)
+        {
+            traceW(L"EOF");
+        }
+        else
+        {
+            errorW(L"fault: ReadFile ctx=%s", ctx->str().c_str());
+        }
+
+        return FspNtStatusFromWin32(lerr);
+    }
+
+    traceW(L"success: ReadFile argBytesTransferred=%lu", *argBytesTransferred);
+
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS CSDriver::pendRead(CALLER_ARG FileContext* ctx, PVOID argBuffer, FILEIO_OFFSET_T argOffset, ULONG argLength,
+    const std::list<std::shared_ptr<ReadFilePartType>>& argParts, PULONG argBytesTransferred)
+{
+    NEW_LOG_BLOCK();
+
+    // 𑗂ƂɕKvȗv̎ʎq
+    // --> obt@͉𑗂܂ŗL
+
+    const auto* opctx = FspFileSystemGetOperationContext();
+    APP_ASSERT(opctx && opctx->Request);
+
+    const auto pending{ std::make_shared<PendingRead>(ctx, argBuffer, argOffset, argLength, opctx->Request->Hint, argParts.size() + 1) };
+
+    for (const auto& filePart: argParts)
+    {
+        const bool registered = filePart->onComplete([this, pending]()
+        {
+            if (--pending->mRemaining == 0)
+            {
+                this->completePendingRead(START_CALLER pending);
+            }
+        });
+
+        if (!registered)
+        {
+            // ɊĂ
+
+            pending->mRemaining--;
+        }
+    }
+
+    if (--pending->mRemaining > 0)
+    {
+        traceW(L"pending mRemaining=%zu", pending->mRemaining.load());
+        return STATUS_PENDING;
+    }
+
+    // o^ĂԂɑSĊƂ́Â܂܉
+
+    traceW(L"all parts done");
+
+    const auto ntstatus = this->syncContent(CONT_CALLER ctx, argOffset, argLength, nullptr);
+    if (!NT_SUCCESS(ntstatus))
+    {
+        errorW(L"fault: syncContent ctx=%s", ctx->str().c_str());
+        return ntstatus;
+    }
+
+    return this->readCacheFile(CONT_CALLER ctx, argBuffer, argOffset, argLength, argBytesTransferred);
+}
+
+void CSDriver::completePendingRead(CALLER_ARG const std::shared_ptr<PendingRead>& argPending)
+{
+    NEW_LOG_BLOCK();
+
+    // ctx ͉𑗐M܂ŗL
+    // --> Cleanup Ȃǂ ctx ̃nhO cancelInflightParts() Ă΂A
+    //     ͑҂Ăp[g̊̊֐ () I܂Ŗ߂Ȃ
+
+    auto* ctx = argPending->mCtx;
+
+    NTSTATUS ntstatus = STATUS_SUCCESS;
+    ULONG bytesTransferred = 0;
+
+    try
+    {
+        // ǂ݂̒fG[Ŏ擾Ȃ͈͂́ÃXbhŎ擾
+        // --> x^XÑXbhŌĂяôŁÃ^XN̊͑҂Ȃ
+
+        std::filesystem::path filePath;
+        CacheExtents extents;
+
+        if (!this->getCacheFilePath(ctx, &filePath))
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+            ntstatus = FspNtStatusFromWin32(lerr);
+        }
+        else if (!this->loadCacheExtents(filePath, &extents))
+        {
+            errorW(L"fault: load filePath=%s", filePath.c_str());
+            ntstatus = FspNtStatusFromWin32(ERROR_IO_DEVICE);
+        }
+        else
+        {
+            const auto readEnd = min(argPending->mOffset + argPending->mLength, extents.getRemoteSize());
+
+            if (argPending->mOffset < readEnd)
+            {
+                const auto& objKey{ ctx->getObjectKey() };
+
+                int partNumber = 0;
+
+                for (const auto& hole: extents.missing(argPending->mOffset, readEnd - argPending->mOffset))
+                {
+                    const auto retryPart{ std::make_shared<ReadFilePartType>(++partNumber, hole.first, hole.second, -1LL) };
+
+                    traceW(L"retry filePart=%s", retryPart->str().c_str());
+
+                    //  Read ⏑݂猩悤ɁA擾̃p[gƂēo^
+
+                    mInflightParts.add(filePath, retryPart);
+
+                    const auto readBytes = this->readFilePart(CONT_CALLER objKey, filePath, retryPart);
+
+                    this->completeFilePart(filePath, retryPart, readBytes);
+
+                    if (retryPart->mLength != readBytes)
+                    {
+                        errorW(L"fault: readFilePart mLength=%lld readBytes=%lld", retryPart->mLength, readBytes);
+
+                        ntstatus = FspNtStatusFromWin32(ERROR_IO_DEVICE);
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (NT_SUCCESS(ntstatus))
+        {
+            ntstatus = this->readCacheFile(CONT_CALLER ctx, argPending->mBuffer, argPending->mOffset, argPending->mLength, &bytesTransferred);
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        errorA("catch exception: what=[%s]", ex.what());
+
+        ntstatus = STATUS_UNSUCCESSFUL;
+    }
+    catch (...)
+    {
+        errorW(L"catch unknown");
+
+        ntstatus = STATUS_UNSUCCESSFUL;
+    }
+
+    // ۗ Read ̉𑗐M
+
+    FSP_FSCTL_TRANSACT_RSP response{};
+
+    response.Size = sizeof(response);
+    response.Kind = FspFsctlTransactReadKind;
+    response.Hint = argPending->mHint;
+    response.IoStatus.Status = ntstatus;
+    response.IoStatus.Information = bytesTransferred;
+
+    traceW(L"SendResponse ntstatus=%ld bytesTransferred=%lu", ntstatus, bytesTransferred);
+
+    FspFileSystemSendResponse(mFileSystem, &response);
+}
+
+void CSDriver::registerCacheFile(CALLER_ARG const std::filesystem::path& argWinPath, const std::filesystem::path& argCacheFilePath, const std::wstring& argETag, FILESIZE_T argFileSize)
+{
+    NEW_LOG_BLOCK();
+
+    // [gXVĂ΁AȑO̓ẽLbVt@C͕sv
+
+    CacheIndex::Entry prevEntry;
+
+    if (mCacheIndex.get(argWinPath, &prevEntry) && prevEntry.mCacheFilePath != argCacheFilePath)
+    {
+        traceW(L"delete prevEntry.mCacheFilePath=%s", prevEntry.mCacheFilePath.c_str());
+
+        mMappedViews.invalidate(argWinPath);
+
+        if (!::DeleteFileW(prevEntry.mCacheFilePath.c_str()))
+        {
+            const auto lerr = ::GetLastError();
+            traceW(L"warn: DeleteFileW lerr=%lu", lerr);
+        }
+    }
+
+    mCacheIndex.set(argWinPath, argCacheFilePath, argETag, argFileSize);
+}
+
+void CSDriver::prefetchSmallFiles(CALLER_ARG const std::list<std::pair<std::filesystem::path, DirEntryType>>& argCandidates)
+{
+    NEW_LOG_BLOCK();
+
+    const auto maxFileSize = FILESIZE_1KiBll * mRuntimeEnv->PrefetchFileMaxSizeKib;
+    auto remainingBudget = FILESIZE_1MiBll * mRuntimeEnv->PrefetchDirBudgetMib;
+
+    for (const auto& [winPath, dirEntry]: argCandidates)
+    {
+        const auto fileSize = static_cast<FILESIZE_T>(dirEntry->mFileInfo.FileSize);
+
+        if (fileSize == 0 || fileSize > maxFileSize || fileSize > remainingBudget)
+        {
+            continue;
+        }
+
+        // Ŝ擾ς̂̂͑ΏۊO
+        // --> ꗗ ETag 킩Ȃ̂ŁATCYŔf
+
+        CacheIndex::Entry entry;
+
+        if (mCacheIndex.get(winPath, &entry) && entry.mFileSize == fileSize && entry.mPresentBytes >= fileSize)
+        {
+            traceW(L"cached winPath=%s", winPath.c_str());
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock_{ mPrefetchGuard };
+
+            if (!mPrefetchQueued.insert(winPath).second)
+            {
+                traceW(L"already queued winPath=%s", winPath.c_str());
+                continue;
+            }
+        }
+
+        remainingBudget -= fileSize;
+
+        traceW(L"addTask winPath=%s fileSize=%lld", winPath.c_str(), fileSize);
+
+        this->getWorker(L"delayed")->addTask(new PrefetchFileTask{ this, winPath });
+    }
+}
+
+void CSDriver::prefetchFile(CALLER_ARG const std::filesystem::path& argWinPath)
+{
+    NEW_LOG_BLOCK();
+
+    std::optional<ObjectKey> optObjKey;
+    std::filesystem::path filePath;
+    std::list<std::shared_ptr<ReadFilePartType>> fileParts;
+
+    // 1) t@Cɂr̒ŃLbVt@C
+
+    {
+        UnprotectedShare<FileNameGuard> unsafeShare{ &mFileNameGuard, argWinPath };
+        {
+            const auto safeShare{ unsafeShare.lock() };
+
+            // I[v̂̂ Read ł̎擾ɔC
+
+            if (mOpenDirEntry.get(argWinPath))
+            {
+                traceW(L"opened argWinPath=%s", argWinPath.c_str());
+                return;
+            }
+
+            // Abv[h҂̂̂́ALbVt@CB̓eȂ̂œȂ
+
+            if (mWriteBack.contains(argWinPath))
+            {
+                traceW(L"write back argWinPath=%s", argWinPath.c_str());
+                return;
+            }
+
+            // Open Ɠ񂩂LbVt@C߂
+
+            const auto dirEntry{ this->getDirEntryByWinPath(CONT_CALLER argWinPath) };
+            if (!dirEntry || dirEntry->mFileType != FileTypeEnum::File)
+            {
+                traceW(L"not a file argWinPath=%s", argWinPath.c_str());
+                return;
+            }
+
+            optObjKey = ObjectKey::fromWinPath(argWinPath);
+            if (!optObjKey)
+            {
+                errorW(L"fault: fromWinPath argWinPath=%s", argWinPath.c_str());
+                return;
+            }
+
+            const auto etag{ getDirEntryETag(dirEntry) };
+            const auto fileSize = static_cast<FILESIZE_T>(dirEntry->mFileInfo.FileSize);
+
+            std::filesystem::path cacheFilePath;
+
+            if (!resolveCacheFilePath(mRuntimeEnv->CacheDataDir, argWinPath, etag, &cacheFilePath))
+            {
+                errorW(L"fault: resolveCacheFilePath argWinPath=%s", argWinPath.c_str());
+                return;
+            }
+
+            this->promoteCacheFile(CONT_CALLER argWinPath, etag, cacheFilePath);
+            this->adoptSharedCacheFile(CONT_CALLER etag, fileSize, cacheFilePath);
+
+            const auto ntstatus = syncAttributes(dirEntry, cacheFilePath);
+            if (!NT_SUCCESS(ntstatus))
+            {
+                errorW(L"fault: syncAttributes dirEntry=%s", dirEntry->str().c_str());
+                return;
+            }
+
+            this->registerCacheFile(CONT_CALLER argWinPath, cacheFilePath, etag, fileSize);
+
+            CacheExtents extents;
+
+            if (!this->loadCacheExtents(cacheFilePath, &extents))
+            {
+                errorW(L"fault: loadCacheExtents cacheFilePath=%s", cacheFilePath.c_str());
+                return;
+            }
+
+            if (extents.getETag() != etag)
+            {
+                // [JŕύXꂽ̂͑ΏۊO
+
+                traceW(L"modified argWinPath=%s extents=%s", argWinPath.c_str(), extents.str().c_str());
+                return;
+            }
+
+            // 擾ς͈̔͂͑ΏۊO
+            // --> ݂ ETag őŜĂΉȂ
+
+            const auto holes{ extents.missing(0, fileSize) };
+
+            if (holes.empty())
+            {
+                traceW(L"cached argWinPath=%s extents=%s", argWinPath.c_str(), extents.str().c_str());
+                return;
+            }
+
+            // 擾̃p[g̓nh擾pXŊǗĂ
+
+            FileHandle file = ::CreateFileW(
+                cacheFilePath.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                NULL,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                NULL);
+
+            if (file.invalid())
+            {
+                const auto lerr = ::GetLastError();
+
+                errorW(L"fault: CreateFileW lerr=%lu cacheFilePath=%s", lerr, cacheFilePath.c_str());
+                return;
+            }
+
+            if (!GetFileNameFromHandle(file.handle(), &filePath))
+            {
+                const auto lerr = ::GetLastError();
+
+                errorW(L"fault: GetFileNameFromHandle lerr=%lu", lerr);
+                return;
+            }
+
+            // ܂ł͎擾̃p[gƂēo^
+            // --> ̊ԂɃI[vꂽƂ́ARead ͂̃p[g̊҂
+
+            int partNumber = 0;
+
+            for (const auto& hole: holes)
+            {
+                const auto filePart{ std::make_shared<ReadFilePartType>(++partNumber, hole.first, hole.second, -1LL) };
+
+                mInflightParts.add(filePath, filePart);
+
+                fileParts.push_back(filePart);
+            }
+        }
+    }
+
+    // 2) r̊OŖ擾͈̔͂擾
+
+    for (const auto& filePart: fileParts)
+    {
+        traceW(L"readFilePart filePart=%s", filePart->str().c_str());
+
+        const auto result = this->readFilePart(CONT_CALLER *optObjKey, filePath, filePart);
+
+        this->completeFilePart(filePath, filePart, result);
+    }
+}
+
+void CSDriver::endPrefetch(const std::filesystem::path& argWinPath)
+{
+    std::lock_guard<std::mutex> lock_{ mPrefetchGuard };
+
+    mPrefetchQueued.erase(argWinPath);
+}
+
 }   // namespace CSEDRV
 
 // EOF
\ No newline at end of file
@@ -0,0 +1,411 @@
+#include "CacheExtents.hpp"
+
+using namespace CSELIB;
+
+// ͈͏ۑփf[^Xg[̖O
+
+static const wchar_t* const EXTENTS_STREAM_NAME = L":wincse-extents";
+
+static const UINT32 EXTENTS_SIGNATURE = 0x33585457;     // "WTX3"
+static const UINT32 EXTENTS_SIGNATURE_V2 = 0x32585457;  // "WTX2" (`FbNTȂ)
+
+// wb_̌ ETag (mETagLength )A͈ (mCount ) ̏ɑ
+
+struct ExtentsHeader
+{
+    UINT32      mSignature;
+    UINT32      mCount;
+    FILESIZE_T  mRemoteSize;
+    UINT32      mETagLength;
+    UINT32      mChecksum;      // wb_ȍ~̓e FNV-1a
+};
+
+static UINT32 computeChecksum(const BYTE* argData, size_t argSize, UINT32 argHash = 2166136261U)
+{
+    // ُIœr܂ŏ܂ꂽeo邽
+
+    for (size_t i=0; i<argSize; i++)
+    {
+        argHash = (argHash ^ argData[i]) * 16777619U;
+    }
+
+    return argHash;
+}
+
+static std::wstring toStreamPath(const std::filesystem::path& argCacheFilePath)
+{
+    return argCacheFilePath.wstring() + EXTENTS_STREAM_NAME;
+}
+
+namespace CSEDRV {
+
+void CacheExtents::reset(FILESIZE_T argRemoteSize, const std::wstring& argETag)
+{
+    mRanges.clear();
+    mRemoteSize = argRemoteSize;
+    mETag = argETag;
+}
+
+void CacheExtents::rebind(FILESIZE_T argRemoteSize, const std::wstring& argETag)
+{
+    // 擾ς͈̔͂͂̂܂܂ɂāAΉ郊[g̓eւ
+    // --> ͈͊Ô݂̂͑Ȃ̂Ŏ̂Ă
+
+    this->truncate(argRemoteSize);
+
+    mRemoteSize = argRemoteSize;
+    mETag = argETag;
+}
+
+void CacheExtents::add(FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength)
+{
+    if (argLength <= 0)
+    {
+        return;
+    }
+
+    auto begin = argOffset;
+    auto end = argOffset + argLength;
+
+    // dȂA܂͗אڂ͈͂
+
+    auto it{ mRanges.upper_bound(begin) };
+
+    if (it != mRanges.begin())
+    {
+        const auto prev{ std::prev(it) };
+
+        if (prev->second >= begin)
+        {
+            begin = prev->first;
+            end = max(end, prev->second);
+
+            mRanges.erase(prev);
+        }
+    }
+
+    while (it != mRanges.end() && it->first <= end)
+    {
+        end = max(end, it->second);
+
+        it = mRanges.erase(it);
+    }
+
+    mRanges.emplace(begin, end);
+}
+
+void CacheExtents::truncate(FILESIZE_T argFileSize)
+{
+    // ؂l߂ʒuȍ~͈̔͂폜
+
+    mRanges.erase(mRanges.lower_bound(argFileSize), mRanges.end());
+
+    if (!mRanges.empty())
+    {
+        auto& last{ std::prev(mRanges.end())->second };
+
+        if (last > argFileSize)
+        {
+            last = argFileSize;
+        }
+    }
+
+    // ؂l߂ʒuȍ~̓[g̓eł͂ȂȂ
+
+    if (mRemoteSize > argFileSize)
+    {
+        mRemoteSize = argFileSize;
+    }
+}
+
+void CacheExtents::merge(const CacheExtents& argOther)
+{
+    // ͈̔͂킹A[g̓eƂĎĝ͗ŎcĂ镔܂
+
+    for (const auto& it: argOther.mRanges)
+    {
+        this->add(it.first, it.second - it.first);
+    }
+
+    if (mRemoteSize > argOther.mRemoteSize)
+    {
+        mRemoteSize = argOther.mRemoteSize;
+    }
+}
+
+bool CacheExtents::contains(FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength) const
+{
+    return missing(argOffset, argLength).empty();
+}
+
+std::list<CacheExtents::RangeType> CacheExtents::missing(FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength) const
+{
+    std::list<RangeType> ret;
+
+    // [g̃TCY𒴂镔̓[Jō쐬ꂽ̂Ȃ̂őΏۊO
+
+    const auto end = min(argOffset + argLength, mRemoteSize);
+    auto pos = argOffset;
+
+    auto it{ mRanges.upper_bound(pos) };
+
+    if (it != mRanges.begin())
+    {
+        const auto prev{ std::prev(it) };
+
+        if (prev->second > pos)
+        {
+            pos = prev->second;
+        }
+    }
+
+    while (pos < end)
+    {
+        if (it == mRanges.end() || it->first >= end)
+        {
+            ret.emplace_back(pos, end - pos);
+            break;
+        }
+
+        if (it->first > pos)
+        {
+            ret.emplace_back(pos, it->first - pos);
+        }
+
+        pos = max(pos, it->second);
+
+        ++it;
+    }
+
+    return ret;
+}
+
+std::list<CacheExtents::RangeType> CacheExtents::coalesce(const std::list<RangeType>& argRanges, FILEIO_LENGTH_T argMaxGap)
+{
+    // ɕ񂾔͈͂̂AԊu argMaxGap ȉ̂̂ɂ܂Ƃ߂
+    // --> Ԃ̕擾ƂɂȂ
+
+    std::list<RangeType> ret;
+
+    for (const auto& range: argRanges)
+    {
+        if (!ret.empty())
+        {
+            auto& last{ ret.back() };
+            const auto lastEnd = last.first + last.second;
+
+            APP_ASSERT(lastEnd <= range.first);
+
+            if (range.first - lastEnd <= argMaxGap)
+            {
+                last.second = range.first + range.second - last.first;
+                continue;
+            }
+        }
+
+        ret.push_back(range);
+    }
+
+    return ret;
+}
+
+FILEIO_LENGTH_T CacheExtents::presentBytes() const
+{
+    FILEIO_LENGTH_T ret = 0;
+
+    for (const auto& it: mRanges)
+    {
+        ret += it.second - it.first;
+    }
+
+    return ret;
+}
+
+bool CacheExtents::load(const std::filesystem::path& argCacheFilePath)
+{
+    NEW_LOG_BLOCK();
+
+    const auto streamPath{ toStreamPath(argCacheFilePath) };
+
+    FileHandle file = ::CreateFileW(
+        streamPath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (file.invalid())
+    {
+        traceW(L"not exists streamPath=%s", streamPath.c_str());
+        return false;
+    }
+
+    ExtentsHeader header{};
+    DWORD bytesRead = 0;
+
+    if (!::ReadFile(file.handle(), &header, sizeof(header), &bytesRead, NULL) || bytesRead != sizeof(header))
+    {
+        errorW(L"fault: ReadFile header streamPath=%s", streamPath.c_str());
+        return false;
+    }
+
+    if ((header.mSignature != EXTENTS_SIGNATURE && header.mSignature != EXTENTS_SIGNATURE_V2) || header.mRemoteSize < 0 ||
+        header.mCount > MAXDWORD / (sizeof(FILEIO_OFFSET_T) * 2) || header.mETagLength > MAXWORD)
+    {
+        errorW(L"fault: invalid header streamPath=%s", streamPath.c_str());
+        return false;
+    }
+
+    std::wstring etag(header.mETagLength, L'\0');
+    const auto etagBytes = static_cast<DWORD>(etag.size() * sizeof(wchar_t));
+
+    if (etagBytes > 0)
+    {
+        if (!::ReadFile(file.handle(), etag.data(), etagBytes, &bytesRead, NULL) || bytesRead != etagBytes)
+        {
+            errorW(L"fault: ReadFile etag streamPath=%s", streamPath.c_str());
+            return false;
+        }
+    }
+
+    std::vector<FILEIO_OFFSET_T> buffer(header.mCount * 2ULL);
+    const auto bufferBytes = static_cast<DWORD>(buffer.size() * sizeof(FILEIO_OFFSET_T));
+
+    if (bufferBytes > 0)
+    {
+        if (!::ReadFile(file.handle(), buffer.data(), bufferBytes, &bytesRead, NULL) || bytesRead != bufferBytes)
+        {
+            errorW(L"fault: ReadFile ranges streamPath=%s", streamPath.c_str());
+            return false;
+        }
+    }
+
+    if (header.mSignature == EXTENTS_SIGNATURE)
+    {
+        auto checksum = computeChecksum(reinterpret_cast<const BYTE*>(etag.data()), etagBytes);
+        checksum = computeChecksum(reinterpret_cast<const BYTE*>(buffer.data()), bufferBytes, checksum);
+
+        if (checksum != header.mChecksum)
+        {
+            errorW(L"fault: checksum streamPath=%s", streamPath.c_str());
+            return false;
+        }
+    }
+
+    this->reset(header.mRemoteSize, etag);
+
+    for (size_t i=0; i<buffer.size(); i+=2)
+    {
+        this->add(buffer[i], buffer[i + 1] - buffer[i]);
+    }
+
+    return true;
+}
+
+bool CacheExtents::save(const std::filesystem::path& argCacheFilePath) const
+{
+    NEW_LOG_BLOCK();
+
+    const auto streamPath{ toStreamPath(argCacheFilePath) };
+
+    // CREATE_ALWAYS ͉B̃t@CŎŝ OPEN_ALWAYS ŊJĐ؂l߂
+
+    FileHandle file = ::CreateFileW(
+        streamPath.c_str(),
+        GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (file.invalid())
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: CreateFileW lerr=%lu streamPath=%s", lerr, streamPath.c_str());
+        return false;
+    }
+
+    // ̃nhł݂̏ł̓^CX^vXVȂ
+    // --> x^XNĂяoĂ[gƂ̓ԂȂ悤
+
+    FILETIME ftNoUpdate{ MAXDWORD, MAXDWORD };
+
+    if (!::SetFileTime(file.handle(), NULL, &ftNoUpdate, &ftNoUpdate))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: SetFileTime lerr=%lu streamPath=%s", lerr, streamPath.c_str());
+        return false;
+    }
+
+    ExtentsHeader header{ EXTENTS_SIGNATURE, static_cast<UINT32>(mRanges.size()), mRemoteSize, static_cast<UINT32>(mETag.size()), 0 };
+
+    const auto etagBytes = mETag.size() * sizeof(wchar_t);
+
+    std::vector<BYTE> buffer(sizeof(header) + etagBytes + mRanges.size() * sizeof(FILEIO_OFFSET_T) * 2);
+
+    memcpy(buffer.data() + sizeof(header), mETag.data(), etagBytes);
+
+    auto* pos = reinterpret_cast<FILEIO_OFFSET_T*>(buffer.data() + sizeof(header) + etagBytes);
+
+    for (const auto& it: mRanges)
+    {
+        *pos++ = it.first;
+        *pos++ = it.second;
+    }
+
+    header.mChecksum = computeChecksum(buffer.data() + sizeof(header), buffer.size() - sizeof(header));
+
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    DWORD bytesWritten = 0;
+
+    if (!::WriteFile(file.handle(), buffer.data(), static_cast<DWORD>(buffer.size()), &bytesWritten, NULL) || bytesWritten != buffer.size())
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: WriteFile lerr=%lu streamPath=%s", lerr, streamPath.c_str());
+        return false;
+    }
+
+    if (!::SetEndOfFile(file.handle()))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: SetEndOfFile lerr=%lu streamPath=%s", lerr, streamPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+std::wstring CacheExtents::str() const
+{
+    std::wostringstream ss;
+
+    ss << L"mRemoteSize=" << mRemoteSize;
+    ss << L" mETag=" << mETag;
+    ss << L" mRanges=[";
+
+    for (auto it=mRanges.cbegin(); it!=mRanges.cend(); ++it)
+    {
+        if (it != mRanges.cbegin())
+        {
+            ss << L',';
+        }
+
+        ss << it->first << L'-' << it->second;
+    }
+
+    ss << L']';
+
+    return ss.str();
+}
+
+}   // namespace CSEDRV
+
+// EOF
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+namespace CSEDRV
+{
+
+//
+// LbVt@C̒Ń_E[h (܂̓[Jō쐬) ͈̔͂Ǘ
+//
+// LbVt@C̓[gƓTCỸXp[XEt@CƂč쐬A
+// ۂɃf[^݂͈͂̃NXŋL^B
+// e̓LbVt@C̑փf[^Xg[ɕۑ̂ŁALbVt@C
+// l[폜ɒǐB
+//
+
+class CacheExtents final
+{
+public:
+	using RangeType = std::pair<CSELIB::FILEIO_OFFSET_T, CSELIB::FILEIO_LENGTH_T>;
+
+private:
+	// Jnʒu -> Iʒu (Iʒu͊܂܂Ȃ)
+
+	std::map<CSELIB::FILEIO_OFFSET_T, CSELIB::FILEIO_OFFSET_T> mRanges;
+
+	// [g擾łȅ
+	// --> ȍ~͈̔͂̓[Jō쐬ꂽ̂Ȃ̂ŁA_E[h̑ΏۊO
+
+	CSELIB::FILESIZE_T mRemoteSize = 0LL;
+
+	// 擾ẽ[gł ETag
+	// --> [JŕύXꂽƂ͋ɂȂA[gƂ̔rɂ͎gȂ
+
+	std::wstring mETag;
+
+public:
+	void reset(CSELIB::FILESIZE_T argRemoteSize, const std::wstring& argETag);
+	void rebind(CSELIB::FILESIZE_T argRemoteSize, const std::wstring& argETag);
+	void add(CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength);
+	void truncate(CSELIB::FILESIZE_T argFileSize);
+	void merge(const CacheExtents& argOther);
+
+	bool contains(CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) const;
+	std::list<RangeType> missing(CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) const;
+
+	static std::list<RangeType> coalesce(const std::list<RangeType>& argRanges, CSELIB::FILEIO_LENGTH_T argMaxGap);
+
+	CSELIB::FILESIZE_T getRemoteSize() const
+	{
+		return mRemoteSize;
+	}
+
+	const std::wstring& getETag() const
+	{
+		return mETag;
+	}
+
+	void setETag(const std::wstring& argETag)
+	{
+		mETag = argETag;
+	}
+
+	void markModified()
+	{
+		mETag.clear();
+	}
+
+	CSELIB::FILEIO_LENGTH_T presentBytes() const;
+
+	bool load(const std::filesystem::path& argCacheFilePath);
+	bool save(const std::filesystem::path& argCacheFilePath) const;
+
+	std::wstring str() const;
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
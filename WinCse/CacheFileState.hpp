@@ -0,0 +1,91 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+#include "CacheExtents.hpp"
+
+namespace CSEDRV
+{
+
+//
+// t@CEReLXg̃LbVt@C̏
+//
+// Read ̂тɃnhLbVt@C̃pX擾A͈͏ǂݍނ
+//  Read ł̓VXeR[̎Ԃ唼߂̂ŁAǑʂێB
+//
+// ͈͏͑镪ɂ͕ێĂeŴ܂܂Ȃ̂ŖȂAk
+// (؂l߁A[g̍XV) LbVt@C̃l[ƐȂȂB
+// ̂Ƃ CSDriver i߂̂ŁAオvƂėp
+//
+// x^XÑXbhQƂ̂Ŕr
+//
+
+class CacheFileState final
+{
+	mutable std::mutex mGuard;
+
+	// 擾Ƃ̐ (0 ͖擾)
+
+	UINT64 mEpoch = 0ULL;
+
+	std::filesystem::path mCacheFilePath;
+	std::optional<CacheExtents> mExtents;
+
+public:
+	bool getPath(UINT64 argEpoch, std::filesystem::path* pPath) const
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		if (mEpoch != argEpoch || mCacheFilePath.empty())
+		{
+			return false;
+		}
+
+		*pPath = mCacheFilePath;
+
+		return true;
+	}
+
+	void setPath(UINT64 argEpoch, const std::filesystem::path& argPath)
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		if (mEpoch != argEpoch)
+		{
+			mEpoch = argEpoch;
+			mExtents.reset();
+		}
+
+		mCacheFilePath = argPath;
+	}
+
+	// ێĂ͈͏ŁAׂ͈͂̂Ă݂邱ƂmFł邩
+
+	bool contains(UINT64 argEpoch, CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) const
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		if (mEpoch != argEpoch || !mExtents)
+		{
+			return false;
+		}
+
+		return mExtents->contains(argOffset, argLength);
+	}
+
+	void setExtents(UINT64 argEpoch, const CacheExtents& argExtents)
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		if (mEpoch != argEpoch)
+		{
+			mEpoch = argEpoch;
+			mCacheFilePath.clear();
+		}
+
+		mExtents = argExtents;
+	}
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
@@ -0,0 +1,657 @@
+#include "CacheIndex.hpp"
+
+using namespace CSELIB;
+
+// }NɂKv͂ȂA킩₷̂
+
+#if defined(THREAD_SAFE)
+#error "THREAD_SAFFE(): already defined"
+#endif
+
+#define THREAD_SAFE()       std::lock_guard<std::mutex> lock_{ mGuard }
+
+// W[i̓t@CEwb_̌ɃR[hǋLĂ
+// pX̃R[h͌̂̂LŁArŐ؂ꂽR[h͖
+
+static const UINT32 INDEX_SIGNATURE = 0x31584957;       // "WIX1"
+
+static const UINT32 RECORD_TYPE_SET = 0x54455353;       // "SSET"
+static const UINT32 RECORD_TYPE_REMOVE = 0x4D455252;    // "RREM"
+
+struct IndexFileHeader
+{
+    UINT32      mSignature;
+    UINT32      mReserved;
+};
+
+struct IndexRecordHeader
+{
+    UINT32      mType;
+    UINT32      mBodyBytes;
+};
+
+// SET R[h͂̌ Windows ̃pXALbVt@C (΃pX)AETag 
+
+struct IndexSetBody
+{
+    FILESIZE_T      mFileSize;
+    FILEIO_LENGTH_T mPresentBytes;
+    UTC_MILLIS_T    mLastAccessMillis;
+    UINT32          mWinPathLength;
+    UINT32          mCacheFileNameLength;
+    UINT32          mETagLength;
+    UINT32          mReserved;
+};
+
+// REMOVE R[h͂̌ Windows ̃pX
+
+struct IndexRemoveBody
+{
+    UINT32      mWinPathLength;
+    UINT32      mReserved;
+};
+
+// R[hGgɑ΂Ăȏ㑝W[il߂
+
+static const size_t JOURNAL_COMPACT_MARGIN = 1024;
+
+static void appendRecordHeader(std::vector<BYTE>* pBuffer, UINT32 argType, size_t argBodyBytes)
+{
+    const IndexRecordHeader header{ argType, static_cast<UINT32>(argBodyBytes) };
+
+    AppendBytesToBuffer(pBuffer, &header, sizeof(header));
+}
+
+static bool writeAll(HANDLE argHandle, const std::vector<BYTE>& argBuffer)
+{
+    DWORD bytesWritten = 0;
+
+    return ::WriteFile(argHandle, argBuffer.data(), static_cast<DWORD>(argBuffer.size()), &bytesWritten, NULL) && bytesWritten == argBuffer.size();
+}
+
+static void makeSetRecord(const std::wstring& argWinPath, const std::wstring& argCacheFileName, const CSEDRV::CacheIndex::Entry& argEntry, std::vector<BYTE>* pBuffer)
+{
+    const IndexSetBody body
+    {
+        argEntry.mFileSize,
+        argEntry.mPresentBytes,
+        argEntry.mLastAccessMillis,
+        static_cast<UINT32>(argWinPath.size()),
+        static_cast<UINT32>(argCacheFileName.size()),
+        static_cast<UINT32>(argEntry.mETag.size()),
+        0
+    };
+
+    const auto stringBytes = (argWinPath.size() + argCacheFileName.size() + argEntry.mETag.size()) * sizeof(wchar_t);
+
+    appendRecordHeader(pBuffer, RECORD_TYPE_SET, sizeof(body) + stringBytes);
+    AppendBytesToBuffer(pBuffer, &body, sizeof(body));
+    AppendBytesToBuffer(pBuffer, argWinPath.data(), argWinPath.size() * sizeof(wchar_t));
+    AppendBytesToBuffer(pBuffer, argCacheFileName.data(), argCacheFileName.size() * sizeof(wchar_t));
+    AppendBytesToBuffer(pBuffer, argEntry.mETag.data(), argEntry.mETag.size() * sizeof(wchar_t));
+}
+
+namespace CSEDRV {
+
+bool CacheIndex::open(const std::filesystem::path& argCacheDataDir)
+{
+    NEW_LOG_BLOCK();
+
+    THREAD_SAFE();
+
+    mCacheDataDir = argCacheDataDir;
+    mMap.clear();
+    mLru.clear();
+    mWinPaths.clear();
+    mTotalBytes = 0LL;
+
+    const auto journalPath{ mCacheDataDir / CACHE_INDEX_FNAME };
+
+    if (::GetFileAttributesW(journalPath.c_str()) != INVALID_FILE_ATTRIBUTES)
+    {
+        if (!this->loadJournal(journalPath))
+        {
+            // ĂƂ͋̏Ԃn߂
+
+            errorW(L"fault: loadJournal journalPath=%s", journalPath.c_str());
+
+            mMap.clear();
+        }
+    }
+
+    // O̒~ɍ폜ꂽLbVt@C͑ΏۊO
+    // --> GgɊmF̂ŁAfBNg͕̑sv
+
+    for (auto it=mMap.begin(); it!=mMap.end(); )
+    {
+        if (::GetFileAttributesW(it->second.mCacheFilePath.c_str()) == INVALID_FILE_ATTRIBUTES)
+        {
+            traceW(L"not exists: mCacheFilePath=%s", it->second.mCacheFilePath.c_str());
+
+            it = mMap.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (const auto& it: mMap)
+    {
+        this->attach(it.first, it.second);
+    }
+
+    traceW(L"mMap.size=%zu mTotalBytes=%lld", mMap.size(), mTotalBytes);
+
+    // LȃGĝ݂ŃW[i蒼
+
+    return this->rewriteJournal();
+}
+
+void CacheIndex::close()
+{
+    THREAD_SAFE();
+
+    mJournal.close();
+}
+
+bool CacheIndex::loadJournal(const std::filesystem::path& argJournalPath)
+{
+    NEW_LOG_BLOCK();
+
+    FileHandle file = ::CreateFileW(
+        argJournalPath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (file.invalid())
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: CreateFileW lerr=%lu argJournalPath=%s", lerr, argJournalPath.c_str());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if (!::GetFileSizeEx(file.handle(), &fileSize) || fileSize.QuadPart > MAXDWORD)
+    {
+        errorW(L"fault: GetFileSizeEx argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    std::vector<BYTE> buffer(static_cast<size_t>(fileSize.QuadPart));
+    DWORD bytesRead = 0;
+
+    if (!::ReadFile(file.handle(), buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, NULL) || bytesRead != buffer.size())
+    {
+        errorW(L"fault: ReadFile argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    const auto* pos = buffer.data();
+    const auto* const end = buffer.data() + buffer.size();
+
+    IndexFileHeader fileHeader;
+
+    if (static_cast<size_t>(end - pos) < sizeof(fileHeader))
+    {
+        errorW(L"fault: too short argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    memcpy(&fileHeader, pos, sizeof(fileHeader));
+    pos += sizeof(fileHeader);
+
+    if (fileHeader.mSignature != INDEX_SIGNATURE)
+    {
+        errorW(L"fault: invalid signature argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    size_t numRecords = 0;
+
+    while (static_cast<size_t>(end - pos) >= sizeof(IndexRecordHeader))
+    {
+        IndexRecordHeader header;
+
+        memcpy(&header, pos, sizeof(header));
+
+        const auto* body = pos + sizeof(header);
+
+        if (static_cast<size_t>(end - body) < header.mBodyBytes)
+        {
+            // ݂̓rŒ~R[h
+
+            traceW(L"warn: truncated record offset=%zu", static_cast<size_t>(pos - buffer.data()));
+            break;
+        }
+
+        const auto* const bodyEnd = body + header.mBodyBytes;
+
+        switch (header.mType)
+        {
+            case RECORD_TYPE_SET:
+            {
+                IndexSetBody setBody;
+
+                if (header.mBodyBytes < sizeof(setBody))
+                {
+                    errorW(L"fault: invalid set record");
+                    return false;
+                }
+
+                memcpy(&setBody, body, sizeof(setBody));
+                body += sizeof(setBody);
+
+                std::wstring winPath;
+                std::wstring cacheFileName;
+                Entry entry;
+
+                if (!ReadStringFromBuffer(body, bodyEnd, setBody.mWinPathLength, &winPath))
+                {
+                    errorW(L"fault: ReadStringFromBuffer winPath");
+                    return false;
+                }
+
+                body += winPath.size() * sizeof(wchar_t);
+
+                if (!ReadStringFromBuffer(body, bodyEnd, setBody.mCacheFileNameLength, &cacheFileName))
+                {
+                    errorW(L"fault: ReadStringFromBuffer cacheFileName");
+                    return false;
+                }
+
+                body += cacheFileName.size() * sizeof(wchar_t);
+
+                if (!ReadStringFromBuffer(body, bodyEnd, setBody.mETagLength, &entry.mETag))
+                {
+                    errorW(L"fault: ReadStringFromBuffer mETag");
+                    return false;
+                }
+
+                entry.mCacheFilePath = mCacheDataDir / cacheFileName;
+                entry.mFileSize = setBody.mFileSize;
+                entry.mPresentBytes = setBody.mPresentBytes;
+                entry.mLastAccessMillis = setBody.mLastAccessMillis;
+
+                mMap[winPath] = std::move(entry);
+
+                break;
+            }
+
+            case RECORD_TYPE_REMOVE:
+            {
+                IndexRemoveBody removeBody;
+
+                if (header.mBodyBytes < sizeof(removeBody))
+                {
+                    errorW(L"fault: invalid remove record");
+                    return false;
+                }
+
+                memcpy(&removeBody, body, sizeof(removeBody));
+                body += sizeof(removeBody);
+
+                std::wstring winPath;
+
+                if (!ReadStringFromBuffer(body, bodyEnd, removeBody.mWinPathLength, &winPath))
+                {
+                    errorW(L"fault: ReadStringFromBuffer winPath");
+                    return false;
+                }
+
+                mMap.erase(winPath);
+
+                break;
+            }
+
+            default:
+            {
+                errorW(L"fault: unknown record type=%u", header.mType);
+                return false;
+            }
+        }
+
+        pos = bodyEnd;
+        numRecords++;
+    }
+
+    traceW(L"numRecords=%zu mMap.size=%zu", numRecords, mMap.size());
+
+    return true;
+}
+
+bool CacheIndex::rewriteJournal()
+{
+    NEW_LOG_BLOCK();
+
+    // ꎞt@CɏoĂu
+
+    const auto journalPath{ mCacheDataDir / CACHE_INDEX_FNAME };
+    const auto tempPath{ journalPath.wstring() + L".tmp" };
+
+    mJournal.close();
+
+    {
+        FileHandle file = ::CreateFileW(
+            tempPath.c_str(),
+            GENERIC_WRITE,
+            0,
+            NULL,
+            CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            NULL);
+
+        if (file.invalid())
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: CreateFileW lerr=%lu tempPath=%s", lerr, tempPath.c_str());
+            return false;
+        }
+
+        std::vector<BYTE> buffer;
+
+        const IndexFileHeader fileHeader{ INDEX_SIGNATURE, 0 };
+
+        AppendBytesToBuffer(&buffer, &fileHeader, sizeof(fileHeader));
+
+        for (const auto& it: mMap)
+        {
+            makeSetRecord(it.first, it.second.mCacheFilePath.lexically_relative(mCacheDataDir).wstring(), it.second, &buffer);
+        }
+
+        if (!writeAll(file.handle(), buffer))
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: WriteFile lerr=%lu tempPath=%s", lerr, tempPath.c_str());
+            return false;
+        }
+    }
+
+    if (!::MoveFileExW(tempPath.c_str(), journalPath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: MoveFileExW lerr=%lu tempPath=%s", lerr, tempPath.c_str());
+        return false;
+    }
+
+    // ȍ~̍XV͒ǋL
+
+    mJournal = ::CreateFileW(
+        journalPath.c_str(),
+        FILE_APPEND_DATA,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (mJournal.invalid())
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: CreateFileW lerr=%lu journalPath=%s", lerr, journalPath.c_str());
+        return false;
+    }
+
+    mJournalRecords = mMap.size();
+
+    return true;
+}
+
+bool CacheIndex::appendRecord(const std::vector<BYTE>& argRecord)
+{
+    NEW_LOG_BLOCK();
+
+    if (mJournal.invalid())
+    {
+        // open() sĂƂ݂̓̂ŊǗ
+
+        return false;
+    }
+
+    if (!writeAll(mJournal.handle(), argRecord))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: WriteFile lerr=%lu", lerr);
+        return false;
+    }
+
+    mJournalRecords++;
+
+    if (mJournalRecords > mMap.size() * 2 + JOURNAL_COMPACT_MARGIN)
+    {
+        // pX̃R[h܂̂ŋl߂
+
+        traceW(L"compact mJournalRecords=%zu mMap.size=%zu", mJournalRecords, mMap.size());
+
+        return this->rewriteJournal();
+    }
+
+    return true;
+}
+
+void CacheIndex::attach(const std::wstring& argWinPath, const Entry& argEntry)
+{
+    mLru.emplace(argEntry.mLastAccessMillis, argWinPath);
+    mWinPaths[argEntry.mCacheFilePath.filename().wstring()] = argWinPath;
+    mTotalBytes += argEntry.mPresentBytes;
+}
+
+void CacheIndex::detach(const std::wstring& argWinPath, const Entry& argEntry)
+{
+    mLru.erase({ argEntry.mLastAccessMillis, argWinPath });
+    mWinPaths.erase(argEntry.mCacheFilePath.filename().wstring());
+    mTotalBytes -= argEntry.mPresentBytes;
+}
+
+bool CacheIndex::appendSet(const std::wstring& argWinPath, const Entry& argEntry)
+{
+    std::vector<BYTE> record;
+
+    makeSetRecord(argWinPath, argEntry.mCacheFilePath.lexically_relative(mCacheDataDir).wstring(), argEntry, &record);
+
+    return this->appendRecord(record);
+}
+
+bool CacheIndex::appendRemove(const std::wstring& argWinPath)
+{
+    const IndexRemoveBody body{ static_cast<UINT32>(argWinPath.size()), 0 };
+
+    std::vector<BYTE> record;
+
+    appendRecordHeader(&record, RECORD_TYPE_REMOVE, sizeof(body) + argWinPath.size() * sizeof(wchar_t));
+    AppendBytesToBuffer(&record, &body, sizeof(body));
+    AppendBytesToBuffer(&record, argWinPath.data(), argWinPath.size() * sizeof(wchar_t));
+
+    return this->appendRecord(record);
+}
+
+void CacheIndex::set(const std::wstring& argWinPath, const std::filesystem::path& argCacheFilePath, const std::wstring& argETag, FILESIZE_T argFileSize)
+{
+    THREAD_SAFE();
+
+    const auto inserted{ mMap.try_emplace(argWinPath) };
+    auto& entry{ inserted.first->second };
+
+    if (!inserted.second)
+    {
+        this->detach(argWinPath, entry);
+    }
+
+    if (entry.mCacheFilePath != argCacheFilePath)
+    {
+        // ʂ̓eɂȂ̂ŁA擾ς̗ʂ͈pȂ
+
+        entry.mPresentBytes = 0LL;
+    }
+
+    entry.mCacheFilePath = argCacheFilePath;
+    entry.mETag = argETag;
+    entry.mFileSize = argFileSize;
+    entry.mLastAccessMillis = GetCurrentUtcMillis();
+
+    this->attach(argWinPath, entry);
+    this->appendSet(argWinPath, entry);
+}
+
+bool CacheIndex::get(const std::wstring& argWinPath, Entry* pEntry) const
+{
+    THREAD_SAFE();
+
+    const auto it{ mMap.find(argWinPath) };
+    if (it == mMap.cend())
+    {
+        return false;
+    }
+
+    *pEntry = it->second;
+
+    return true;
+}
+
+bool CacheIndex::remove(const std::wstring& argWinPath, Entry* pEntry)
+{
+    THREAD_SAFE();
+
+    const auto it{ mMap.find(argWinPath) };
+    if (it == mMap.end())
+    {
+        return false;
+    }
+
+    this->detach(argWinPath, it->second);
+
+    if (pEntry)
+    {
+        *pEntry = std::move(it->second);
+    }
+
+    mMap.erase(it);
+
+    this->appendRemove(argWinPath);
+
+    return true;
+}
+
+bool CacheIndex::touch(const std::wstring& argWinPath, FILEIO_LENGTH_T argPresentBytes)
+{
+    THREAD_SAFE();
+
+    const auto it{ mMap.find(argWinPath) };
+    if (it == mMap.end())
+    {
+        return false;
+    }
+
+    this->detach(argWinPath, it->second);
+
+    it->second.mPresentBytes = argPresentBytes;
+    it->second.mLastAccessMillis = GetCurrentUtcMillis();
+
+    this->attach(argWinPath, it->second);
+    this->appendSet(argWinPath, it->second);
+
+    return true;
+}
+
+FILESIZE_T CacheIndex::addPresentBytes(const std::filesystem::path& argCacheFilePath, FILEIO_LENGTH_T argLength)
+{
+    THREAD_SAFE();
+
+    // _E[h̓sxW[iɂ͏Atouch() ł܂Ƃ߂ċL^
+
+    const auto itPath{ mWinPaths.find(argCacheFilePath.filename().wstring()) };
+    if (itPath != mWinPaths.end())
+    {
+        const auto it{ mMap.find(itPath->second) };
+        APP_ASSERT(it != mMap.end());
+
+        it->second.mPresentBytes += argLength;
+        mTotalBytes += argLength;
+    }
+
+    return mTotalBytes;
+}
+
+std::list<std::pair<std::wstring, CacheIndex::Entry>> CacheIndex::oldest(size_t argSkip, size_t argCount) const
+{
+    THREAD_SAFE();
+
+    std::list<std::pair<std::wstring, Entry>> ret;
+
+    if (argSkip >= mLru.size())
+    {
+        return ret;
+    }
+
+    for (auto it=std::next(mLru.cbegin(), argSkip); it!=mLru.cend() && ret.size()<argCount; ++it)
+    {
+        ret.emplace_back(it->second, mMap.at(it->second));
+    }
+
+    return ret;
+}
+
+size_t CacheIndex::prune()
+{
+    NEW_LOG_BLOCK();
+
+    THREAD_SAFE();
+
+    // ̊Oō폜ꂽLbVt@C̃Gg폜
+
+    size_t numPruned = 0;
+
+    for (auto it=mMap.begin(); it!=mMap.end(); )
+    {
+        if (::GetFileAttributesW(it->second.mCacheFilePath.c_str()) == INVALID_FILE_ATTRIBUTES)
+        {
+            traceW(L"not exists: mCacheFilePath=%s", it->second.mCacheFilePath.c_str());
+
+            const auto winPath{ it->first };
+
+            this->detach(it->first, it->second);
+
+            it = mMap.erase(it);
+
+            this->appendRemove(winPath);
+            numPruned++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return numPruned;
+}
+
+size_t CacheIndex::size() const
+{
+    THREAD_SAFE();
+
+    return mMap.size();
+}
+
+FILESIZE_T CacheIndex::totalBytes() const
+{
+    THREAD_SAFE();
+
+    return mTotalBytes;
+}
+
+}   // namespace CSEDRV
+
+#undef THREAD_SAFE
+
+// EOF
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+namespace CSEDRV
+{
+
+//
+// Windows ̃pXƁA̓eێĂLbVt@C̑Ή
+//
+// LbVt@C̖O (oPbg, L[, ETag) 쐬̂ŁA[g
+// XVƕʂ̃t@CɂȂBÂẽt@CAꗗ폜Ƃ
+// LbVt@CT߂ɗp
+//
+// XV̓LbVEfBNg̃W[iɒǋLAT[rX̍ċNɂ
+// fBNg𑖍ɃW[i畜
+//
+// ŏIANZX̏ƃLbVt@C̍vTCYێAeʂ𒴂
+// ƂɌÂ̂폜邽߂ɗp
+//
+
+class CacheIndex final
+{
+public:
+	struct Entry
+	{
+		std::filesystem::path	mCacheFilePath;
+		std::wstring			mETag;
+		CSELIB::FILESIZE_T		mFileSize = 0LL;
+		CSELIB::FILEIO_LENGTH_T	mPresentBytes = 0LL;		// fBXNŎgpĂTCY
+		CSELIB::UTC_MILLIS_T	mLastAccessMillis = 0ULL;
+	};
+
+private:
+	std::filesystem::path mCacheDataDir;
+	std::map<std::wstring, Entry> mMap;
+
+	// ŏIANZX̌Â
+
+	std::set<std::pair<CSELIB::UTC_MILLIS_T, std::wstring>> mLru;
+
+	// LbVt@C Windows ̃pXւ̋t
+	// --> x^XN̓LbVt@C̃pXmȂ
+	// --> nh擾pXƂ͕\LقȂ̂ŁAt@Cň
+
+	std::map<std::wstring, std::wstring> mWinPaths;
+
+	CSELIB::FILESIZE_T mTotalBytes = 0LL;
+
+	// ǋLpɊJ܂܂ɂW[i
+
+	CSELIB::FileHandle mJournal;
+	size_t mJournalRecords = 0;
+
+	mutable std::mutex mGuard;
+
+	void attach(const std::wstring& argWinPath, const Entry& argEntry);
+	void detach(const std::wstring& argWinPath, const Entry& argEntry);
+	bool appendSet(const std::wstring& argWinPath, const Entry& argEntry);
+	bool appendRemove(const std::wstring& argWinPath);
+	bool appendRecord(const std::vector<BYTE>& argRecord);
+	bool loadJournal(const std::filesystem::path& argJournalPath);
+	bool rewriteJournal();
+
+public:
+	bool open(const std::filesystem::path& argCacheDataDir);
+	void close();
+
+	void set(const std::wstring& argWinPath, const std::filesystem::path& argCacheFilePath, const std::wstring& argETag, CSELIB::FILESIZE_T argFileSize);
+	bool get(const std::wstring& argWinPath, Entry* pEntry) const;
+	bool remove(const std::wstring& argWinPath, Entry* pEntry);
+	bool touch(const std::wstring& argWinPath, CSELIB::FILEIO_LENGTH_T argPresentBytes);
+	CSELIB::FILESIZE_T addPresentBytes(const std::filesystem::path& argCacheFilePath, CSELIB::FILEIO_LENGTH_T argLength);
+
+	std::list<std::pair<std::wstring, Entry>> oldest(size_t argSkip, size_t argCount) const;
+	size_t prune();
+
+	size_t size() const;
+	CSELIB::FILESIZE_T totalBytes() const;
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
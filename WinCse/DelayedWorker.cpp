@@ -48,10 +48,23 @@ NTSTATUS DelayedWorker::OnSvcStart(PCWSTR argWorkDir, FSP_FILE_SYSTEM*)
 		core_count = 8;
 	}
 
+	// ]̓sƂ́Ȁ܂ŕɎsł悤ɂ
+
+	if (GetIniBoolW(confPath, mIniSection, L"transfer_auto_tune", true))
+	{
+		core_count = max(core_count, GetIniIntW(confPath, mIniSection, L"transfer_max_parallel", 8, 1, 32));
+	}
+
 	const auto numThreads = GetIniIntW(confPath, mIniSection, L"file_io_threads", core_count, 1, 32);
 
 	traceW(L"numThreads=%d", numThreads);
 
+	// Dx̒Ⴂ^XNʏ̃^XN̎sWȂ悤ɁAɎs鐔𐧌
+
+	mLowTaskMaxRunning = max(1, numThreads / 4);
+
+	traceW(L"mLowTaskMaxRunning=%d", mLowTaskMaxRunning);
+
 	for (int i=0; i<numThreads; i++)
 	{
 		EventHandle hStarted = ::CreateEventW(NULL, FALSE, FALSE, NULL);
@@ -112,6 +125,7 @@ VOID DelayedWorker::OnSvcStop()
 	}
 
 	mTaskQueue.clear();
+	mLowTaskQueue.clear();
 }
 
 void DelayedWorker::listen(int argThreadIndex, HANDLE argStarted)
@@ -175,7 +189,7 @@ void DelayedWorker::listen(int argThreadIndex, HANDLE argStarted)
 
 		while (true)
 		{
-			auto task{ dequeueTask() };
+			auto task{ dequeueTask(false) };
 			if (!task)
 			{
 				traceW(L"(%d): no more oneshot-tasks", argThreadIndex);
@@ -196,6 +210,11 @@ void DelayedWorker::listen(int argThreadIndex, HANDLE argStarted)
 			{
 				errorA("(%d): unknown error, continue", argThreadIndex);
 			}
+
+			if (task->isLowPriority())
+			{
+				this->endLowTask();
+			}
 		}
 	}
 
@@ -203,7 +222,7 @@ void DelayedWorker::listen(int argThreadIndex, HANDLE argStarted)
 
 	while (1)
 	{
-		auto task{ dequeueTask() };
+		auto task{ dequeueTask(true) };
 		if (!task)
 		{
 			traceW(L"(%d): no more oneshot-tasks", argThreadIndex);
@@ -246,7 +265,14 @@ bool DelayedWorker::addTypedTask(IOnDemandTask* argTask)
 		return false;
 	}
 
-	mTaskQueue.emplace_back(argTask);
+	if (argTask->isLowPriority())
+	{
+		mLowTaskQueue.emplace_back(argTask);
+	}
+	else
+	{
+		mTaskQueue.emplace_back(argTask);
+	}
 
 	// WaitForSingleObject() ɒʒm
 
@@ -256,7 +282,7 @@ bool DelayedWorker::addTypedTask(IOnDemandTask* argTask)
 	return true;
 }
 
-std::unique_ptr<IOnDemandTask> DelayedWorker::dequeueTask()
+std::unique_ptr<IOnDemandTask> DelayedWorker::dequeueTask(bool argDraining)
 {
 	THREAD_SAFE();
 
@@ -268,7 +294,31 @@ std::unique_ptr<IOnDemandTask> DelayedWorker::dequeueTask()
 		return ret;
 	}
 
+	// ʏ̃^XNȂƂɁAs̏܂ł͗Dx̒Ⴂ^XNo
+	// --> IɔjƂ͏𖳎
+
+	if (!mLowTaskQueue.empty() && (argDraining || mLowTaskRunning < mLowTaskMaxRunning))
+	{
+		auto ret{ std::move(mLowTaskQueue.front()) };
+		mLowTaskQueue.pop_front();
+
+		if (!argDraining)
+		{
+			mLowTaskRunning++;
+		}
+
+		return ret;
+	}
+
 	return nullptr;
 }
 
+void DelayedWorker::endLowTask()
+{
+	THREAD_SAFE();
+	APP_ASSERT(mLowTaskRunning > 0);
+
+	mLowTaskRunning--;
+}
+
 // EOF
\ No newline at end of file
@@ -14,13 +14,17 @@ private:
 	int													mTaskSkipCount = 0;
 	std::atomic<bool>									mEndWorkerFlag = false;
 	std::deque<std::unique_ptr<CSELIB::IOnDemandTask>>	mTaskQueue;
+	std::deque<std::unique_ptr<CSELIB::IOnDemandTask>>	mLowTaskQueue;
+	int													mLowTaskRunning = 0;
+	int													mLowTaskMaxRunning = 1;
 	CSELIB::EventHandle									mEvent;
 
 	mutable std::mutex									mGuard;
 
 protected:
 	void listen(int argThreadIndex, HANDLE argStarted);
-	std::unique_ptr<CSELIB::IOnDemandTask> dequeueTask();
+	std::unique_ptr<CSELIB::IOnDemandTask> dequeueTask(bool argDraining);
+	void endLowTask();
 
 public:
 	DelayedWorker(const std::wstring& argIniSection);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+#include "CacheExtents.hpp"
+
+namespace CSEDRV
+{
+
+//
+// t@CEReLXgɁAI[vĂύX͈͂L^
+//
+// ύXĂȂ͈͂̓[g̕ύXO̓eƓȂ̂ŁAN[ỸAbv[hł
+// [gŃRs[AύX͈͂𑗂邱ƂłB
+//
+// CacheExtents ͈̔͂ύX͈́A[g̃TCYύXO̓eŎcĂ͈͂
+// ƂĎgBETag ̂Ƃ͕ύXO̓e킩Ȃ̂ŁAŜAbv[h
+//
+
+class DirtyRanges final
+{
+	mutable std::mutex mGuard;
+
+	CacheExtents mRanges;
+
+public:
+	// ύXO̓ẽTCY ETag L^n߂
+
+	void reset(CSELIB::FILESIZE_T argBaseSize, const std::wstring& argBaseETag)
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		mRanges.reset(argBaseSize, argBaseETag);
+	}
+
+	// eSĒuꂽ
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		mRanges.reset(0, L"");
+	}
+
+	void add(CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength)
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		mRanges.add(argOffset, argLength);
+	}
+
+	// ؂l߂ʒuȍ~́AŊgĂύXO̓eł͂Ȃ
+
+	void truncate(CSELIB::FILESIZE_T argFileSize)
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		mRanges.truncate(argFileSize);
+	}
+
+	// ύXO̓eςĂȂ͈
+
+	bool getCleanRanges(CSELIB::FILESIZE_T argFileSize, std::wstring* pBaseETag, std::list<CacheExtents::RangeType>* pRanges) const
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		if (mRanges.getETag().empty())
+		{
+			return false;
+		}
+
+		*pBaseETag = mRanges.getETag();
+		*pRanges = mRanges.missing(0, argFileSize);
+
+		return true;
+	}
+
+	// N[ỸAbv[hɈp
+	// --> L^ĂȂƂ͑ŜAbv[h
+
+	std::optional<CacheExtents> snapshot() const
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		if (mRanges.getETag().empty())
+		{
+			return std::nullopt;
+		}
+
+		return mRanges;
+	}
+
+	void restore(const CacheExtents& argRanges)
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		mRanges = argRanges;
+	}
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
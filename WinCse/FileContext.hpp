@@ -1,6 +1,11 @@
 #pragma once
 
 #include "CSDriverInternal.h"
+#include "ReadAhead.hpp"
+#include "StreamRead.hpp"
+#include "CacheFileState.hpp"
+#include "DirtyRanges.hpp"
+#include "StreamUpload.hpp"
 
 namespace CSEDRV
 {
@@ -14,6 +19,14 @@ private:
 public:
 	PVOID					mDirBuffer = nullptr;
 	mutable DWORD			mFlags = 0;
+	ReadAhead				mReadAhead;
+	StreamRead				mStreamRead;
+	CacheFileState			mCacheState;
+	DirtyRanges				mDirtyRanges;
+
+	// ݂ƕsAbv[h (쐬܂͐؂l߂Ƃ)
+
+	std::shared_ptr<StreamUpload>	mStreamUpload;
 
 	FileContext(const std::filesystem::path& argWinPath, const CSELIB::DirEntryType& argDirEntry)
 		:
@@ -53,6 +53,34 @@ void FileContextSweeper::remove(FileContext* ctx)
 	mOpenAddrs.erase(ctx);
 }
 
+// t@CJĂReNXg̃LbVt@C
+
+bool FileContextSweeper::getCacheFilePath(const std::filesystem::path& argWinPath, std::filesystem::path* pCacheFilePath) const
+{
+	THREAD_SAFE();
+
+	for (auto* ctx: mOpenAddrs)
+	{
+		if (ctx->getWinPath() != argWinPath)
+		{
+			continue;
+		}
+
+		const auto handle = ctx->getWritableHandle();
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			continue;
+		}
+
+		if (GetFileNameFromHandle(handle, pCacheFilePath))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 }	// namespace CSEDRV
 
 // EOF
\ No newline at end of file
@@ -15,6 +15,7 @@ private:
 public:
 	void add(FileContext* ctx);
 	void remove(FileContext* ctx);
+	bool getCacheFilePath(const std::filesystem::path& argWinPath, std::filesystem::path* pCacheFilePath) const;
 
 	~FileContextSweeper();
 };
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+// }NɂKv͂ȂA킩₷̂
+
+#if defined(THREAD_SAFE)
+#error "THREAD_SAFFE(): already defined"
+#endif
+
+#define THREAD_SAFE()       std::lock_guard<std::mutex> lock_{ mGuard }
+
+namespace CSEDRV
+{
+
+//
+// x^XNŃ_E[h̃p[gLbVt@CɊǗ
+//
+// ݂؂l߂̑OɁA͈͂̃_E[h̊҂߂ɗp
+//
+
+class InflightParts final
+{
+	using FilePartListType = std::list<std::shared_ptr<ReadFilePartType>>;
+
+	std::map<std::filesystem::path, FilePartListType> mMap;
+	mutable std::mutex mGuard;
+
+public:
+	void add(const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart)
+	{
+		THREAD_SAFE();
+
+		mMap[argCacheFilePath].push_back(argFilePart);
+	}
+
+	void remove(const std::filesystem::path& argCacheFilePath, const std::shared_ptr<ReadFilePartType>& argFilePart)
+	{
+		THREAD_SAFE();
+
+		const auto it{ mMap.find(argCacheFilePath) };
+		if (it == mMap.end())
+		{
+			return;
+		}
+
+		it->second.remove(argFilePart);
+
+		if (it->second.empty())
+		{
+			mMap.erase(it);
+		}
+	}
+
+	// w肵͈͂ƏdȂp[g擾
+
+	FilePartListType find(const std::filesystem::path& argCacheFilePath, CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) const
+	{
+		THREAD_SAFE();
+
+		FilePartListType ret;
+
+		const auto it{ mMap.find(argCacheFilePath) };
+		if (it == mMap.cend())
+		{
+			return ret;
+		}
+
+		for (const auto& filePart: it->second)
+		{
+			if (filePart->mOffset < argOffset + argLength && argOffset < filePart->mOffset + filePart->mLength)
+			{
+				ret.push_back(filePart);
+			}
+		}
+
+		return ret;
+	}
+
+	FilePartListType findAll(const std::filesystem::path& argCacheFilePath) const
+	{
+		THREAD_SAFE();
+
+		const auto it{ mMap.find(argCacheFilePath) };
+		if (it == mMap.cend())
+		{
+			return {};
+		}
+
+		return it->second;
+	}
+};
+
+}	// namespace CSEDRV
+
+#undef THREAD_SAFE
+
+// EOF
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "MappedViews.hpp"
+
+using namespace CSELIB;
+
+// }NɂKv͂ȂA킩₷̂
+
+#if defined(THREAD_SAFE)
+#error "THREAD_SAFFE(): already defined"
+#endif
+
+#define THREAD_SAFE()       std::lock_guard<std::mutex> lock_{ mGuard }
+
+static bool copyFromView(const BYTE* argSrc, size_t argLength, BYTE* argDst)
+{
+    // y[W̓ǂݍ݂ɎsƂ͗OɂȂ̂ŁARead ̃G[ƂĈ
+
+    __try
+    {
+        memcpy(argDst, argSrc, argLength);
+    }
+    __except (::GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ? EXCEPTION_EXECUTE_HANDLER : EXCEPTION_CONTINUE_SEARCH)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+namespace CSEDRV {
+
+MappedViews::View::~View()
+{
+    if (mBase)
+    {
+        ::UnmapViewOfFile(mBase);
+    }
+
+    if (mMapping)
+    {
+        ::CloseHandle(mMapping);
+    }
+}
+
+void MappedViews::init(FILESIZE_T argCapacity)
+{
+    THREAD_SAFE();
+
+    mEntries.clear();
+    mLru.clear();
+
+    mCapacity = argCapacity;
+    mTotalBytes = 0;
+}
+
+void MappedViews::releaseEntry(std::map<std::wstring, Entry>::iterator argIt)
+{
+    // gp̃r[́AŌ̎QƂȂȂƂɉ
+
+    mTotalBytes -= argIt->second.mView->mSize;
+
+    mLru.erase(argIt->second.mLru);
+    mEntries.erase(argIt);
+}
+
+std::shared_ptr<MappedViews::View> MappedViews::get(const std::wstring& argWinPath, const std::wstring& argVersion)
+{
+    THREAD_SAFE();
+
+    const auto it{ mEntries.find(argWinPath) };
+    if (it == mEntries.end())
+    {
+        return nullptr;
+    }
+
+    if (it->second.mVersion != argVersion)
+    {
+        // [gXVĂ
+
+        this->releaseEntry(it);
+
+        return nullptr;
+    }
+
+    mLru.splice(mLru.begin(), mLru, it->second.mLru);
+
+    return it->second.mView;
+}
+
+std::shared_ptr<MappedViews::View> MappedViews::map(const std::wstring& argWinPath, const std::wstring& argVersion, HANDLE argFile, FILESIZE_T argFileSize)
+{
+    NEW_LOG_BLOCK();
+
+    if (argFileSize <= 0 || argFileSize > mCapacity)
+    {
+        return nullptr;
+    }
+
+    auto view{ std::make_shared<View>() };
+
+    view->mMapping = ::CreateFileMappingW(argFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!view->mMapping)
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: CreateFileMappingW lerr=%lu argWinPath=%s", lerr, argWinPath.c_str());
+        return nullptr;
+    }
+
+    view->mBase = static_cast<const BYTE*>(::MapViewOfFile(view->mMapping, FILE_MAP_READ, 0, 0, static_cast<SIZE_T>(argFileSize)));
+    if (!view->mBase)
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: MapViewOfFile lerr=%lu argWinPath=%s", lerr, argWinPath.c_str());
+        return nullptr;
+    }
+
+    view->mSize = argFileSize;
+
+    THREAD_SAFE();
+
+    const auto it{ mEntries.find(argWinPath) };
+    if (it != mEntries.end())
+    {
+        this->releaseEntry(it);
+    }
+
+    // 𒴂Ȃ悤ɁAłÂr[
+
+    while (!mLru.empty() && mTotalBytes + argFileSize > mCapacity)
+    {
+        this->releaseEntry(mEntries.find(mLru.back()));
+    }
+
+    mLru.push_front(argWinPath);
+    mEntries.emplace(argWinPath, Entry{ argVersion, view, mLru.begin() });
+
+    mTotalBytes += argFileSize;
+
+    traceW(L"argWinPath=%s argFileSize=%lld mTotalBytes=%lld", argWinPath.c_str(), argFileSize, mTotalBytes);
+
+    return view;
+}
+
+void MappedViews::invalidate(const std::wstring& argWinPath)
+{
+    THREAD_SAFE();
+
+    const auto it{ mEntries.find(argWinPath) };
+    if (it == mEntries.end())
+    {
+        return;
+    }
+
+    this->releaseEntry(it);
+}
+
+bool MappedViews::copy(const View& argView, FILEIO_OFFSET_T argOffset, ULONG argLength, PVOID argBuffer)
+{
+    APP_ASSERT(argOffset >= 0 && argOffset + argLength <= argView.mSize);
+
+    return copyFromView(argView.mBase + argOffset, argLength, static_cast<BYTE*>(argBuffer));
+}
+
+std::wstring MappedViews::str() const
+{
+    THREAD_SAFE();
+
+    std::wostringstream ss;
+
+    ss << L"mCapacity=" << mCapacity;
+    ss << L" mTotalBytes=" << mTotalBytes;
+    ss << L" mEntries.size=" << mEntries.size();
+
+    return ss.str();
+}
+
+}   // namespace CSEDRV
+
+#undef THREAD_SAFE
+
+// EOF
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+namespace CSEDRV
+{
+
+//
+// ŜLbVĂt@CǂݎpŃ}bvr[ێ
+//
+// LbVt@Cւ Read  ReadFile ł͂Ȃr[̃Rs[ŕԂ߂
+// pBr[ Windows ̃pXƃ[g̔ (ETag Ȃ) ŎʂA}bvĂ
+// ṽTCY𒴂Ƃ͎gp̌Â̂
+//
+// r[ێĂԂ̓LbVt@C폜łȂ̂ŁAeύXƂ
+// LbVt@C폜Oɂ Windows ̃pXPʂŔj
+//
+
+class MappedViews final
+{
+public:
+	struct View
+	{
+		HANDLE					mMapping = NULL;
+		const BYTE*				mBase = nullptr;
+		CSELIB::FILESIZE_T		mSize = 0;
+
+		~View();
+	};
+
+private:
+	struct Entry
+	{
+		std::wstring			mVersion;
+		std::shared_ptr<View>	mView;
+		std::list<std::wstring>::iterator mLru;
+	};
+
+	CSELIB::FILESIZE_T mCapacity = 0;
+	CSELIB::FILESIZE_T mTotalBytes = 0;
+
+	// gp (擪łV)
+
+	std::list<std::wstring> mLru;
+
+	// Windows ̃pX -> r[
+
+	std::map<std::wstring, Entry> mEntries;
+
+	mutable std::mutex mGuard;
+
+	void releaseEntry(std::map<std::wstring, Entry>::iterator argIt);
+
+public:
+	void init(CSELIB::FILESIZE_T argCapacity);
+
+	bool enabled() const
+	{
+		return mCapacity > 0;
+	}
+
+	std::shared_ptr<View> get(const std::wstring& argWinPath, const std::wstring& argVersion);
+	std::shared_ptr<View> map(const std::wstring& argWinPath, const std::wstring& argVersion, HANDLE argFile, CSELIB::FILESIZE_T argFileSize);
+	void invalidate(const std::wstring& argWinPath);
+
+	static bool copy(const View& argView, CSELIB::FILEIO_OFFSET_T argOffset, ULONG argLength, PVOID argBuffer);
+
+	std::wstring str() const;
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
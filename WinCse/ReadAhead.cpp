@@ -0,0 +1,166 @@
+#include "ReadAhead.hpp"
+
+using namespace CSELIB;
+
+namespace CSEDRV {
+
+void ReadAhead::reset()
+{
+    // 擾̃p[g̓LbVƂėLȂ̂ŁAf͂Ȃ
+
+    mSequentialCount = 0;
+    mWindowParts = 1;
+    mIssuedEnd = 0LL;
+    mBytesPerSec = 0LL;
+}
+
+void ReadAhead::interrupt()
+{
+    for (const auto& filePart: mFileParts)
+    {
+        filePart->mInterrupt = true;
+    }
+
+    mFileParts.clear();
+}
+
+bool ReadAhead::next(FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength, bool argDownloaded,
+    FILEIO_LENGTH_T argPartSize, int argMaxParts, UTC_MILLIS_T argFetchMillis,
+    FILEIO_OFFSET_T* pBegin, FILEIO_OFFSET_T* pEnd)
+{
+    APP_ASSERT(argPartSize > 0);
+
+    if (argMaxParts <= 0 || argLength <= 0)
+    {
+        return false;
+    }
+
+    const auto now = GetCurrentUtcMillis();
+    const auto readEnd = argOffset + argLength;
+
+    if (argOffset != mNextOffset)
+    {
+        // AĂȂ Read Ȃ̂ŁAv蒼
+
+        this->reset();
+
+        mMeasureMillis = now;
+        mMeasureOffset = argOffset;
+    }
+
+    mSequentialCount++;
+    mNextOffset = readEnd;
+
+    if (readEnd - mMeasureOffset >= argPartSize)
+    {
+        // p[gTCYȏxXV
+
+        const auto elapsed = now > mMeasureMillis ? now - mMeasureMillis : 1ULL;
+        const auto bytesPerSec = (readEnd - mMeasureOffset) * 1000LL / static_cast<FILEIO_LENGTH_T>(elapsed);
+
+        mBytesPerSec = mBytesPerSec == 0 ? bytesPerSec : (mBytesPerSec * 3 + bytesPerSec) / 4;
+
+        mMeasureMillis = now;
+        mMeasureOffset = readEnd;
+    }
+
+    if (mSequentialCount < 2)
+    {
+        return false;
+    }
+
+    // p[g̎擾ɂ鎞Ԃŏʂ܂Ȃp[g
+
+    int windowParts = 1;
+
+    if (mBytesPerSec > 0 && argFetchMillis > 0)
+    {
+        const auto bytesDuringFetch = mBytesPerSec * static_cast<FILEIO_LENGTH_T>(argFetchMillis) / 1000LL;
+
+        windowParts = static_cast<int>(min(UNIT_COUNT(bytesDuringFetch, argPartSize) + 1, argMaxParts));
+    }
+
+    if (argDownloaded)
+    {
+        // ǂ݂ԂɍȂ̂Ŋg
+
+        windowParts = max(windowParts, mWindowParts * 2);
+    }
+    else if (windowParts < mWindowParts)
+    {
+        // xȂƂ͏Xɏk
+
+        windowParts = mWindowParts - 1;
+    }
+
+    mWindowParts = min(max(windowParts, 1), argMaxParts);
+
+    // Read ̏I[܂ރp[g܂ł syncContent Ŏ擾Ă̂ŁA̎̃p[g
+
+    const auto base = ALIGN_TO_UNIT(readEnd, argPartSize);
+    const auto begin = max(base, mIssuedEnd);
+    const auto end = base + argPartSize * mWindowParts;
+
+    if (begin >= end)
+    {
+        return false;
+    }
+
+    mIssuedEnd = end;
+
+    *pBegin = begin;
+    *pEnd = end;
+
+    return true;
+}
+
+void ReadAhead::addFilePart(const std::shared_ptr<ReadFilePartType>& argFilePart)
+{
+    // p[g͕sv
+
+    mFileParts.remove_if([](const auto& filePart)
+    {
+        return filePart->isDone();
+    });
+
+    mFileParts.push_back(argFilePart);
+}
+
+void ReadAhead::cancel()
+{
+    // sÕp[g𒆒fāAs̃p[g͊҂
+
+    for (const auto& filePart: mFileParts)
+    {
+        filePart->mInterrupt = true;
+    }
+
+    for (const auto& filePart: mFileParts)
+    {
+        filePart->getResult();
+    }
+
+    mFileParts.clear();
+
+    this->reset();
+
+    mNextOffset = -1LL;
+}
+
+std::wstring ReadAhead::str() const
+{
+    std::wostringstream ss;
+
+    ss << L"mNextOffset=" << mNextOffset;
+    ss << L" mSequentialCount=" << mSequentialCount;
+    ss << L" mWindowParts=" << mWindowParts;
+    ss << L" mIssuedEnd=" << mIssuedEnd;
+    ss << L" mBytesPerSec=" << mBytesPerSec;
+    ss << L" mFileParts.size=" << mFileParts.size();
+
+    return ss.str();
+}
+
+}   // namespace CSEDRV
+
+// EOF
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+namespace CSEDRV
+{
+
+//
+// t@CEReLXg̐ǂ݂̏
+//
+// A Read oÃp[gx^XNŃ_E[hB
+// ǂ݂p[g̓AvP[V̏xƃp[g̎擾Ԃ猈肷B
+//
+// R[obN̓t@CɃbNĂ̂ŁAr͍sȂ
+//
+
+class ReadAhead final
+{
+	// Ɋ҂ Read ̈ʒu
+
+	CSELIB::FILEIO_OFFSET_T mNextOffset = -1LL;
+
+	// A Read ̉
+
+	int mSequentialCount = 0;
+
+	// ǂ݂p[g
+
+	int mWindowParts = 1;
+
+	// ǂ݂o^͈͂̏I[
+
+	CSELIB::FILEIO_OFFSET_T mIssuedEnd = 0LL;
+
+	// x̌v
+
+	CSELIB::UTC_MILLIS_T mMeasureMillis = 0ULL;
+	CSELIB::FILEIO_OFFSET_T mMeasureOffset = 0LL;
+	CSELIB::FILEIO_LENGTH_T mBytesPerSec = 0LL;
+
+	// obNOEhŎ擾̃p[g
+	// --> ǂ݂́AsyncContent  Read ͈͂̊Oɂ́AJƂ̐擪Ɩ
+
+	std::list<std::shared_ptr<ReadFilePartType>> mFileParts;
+
+	void reset();
+	void interrupt();
+
+public:
+	~ReadAhead()
+	{
+		this->interrupt();
+	}
+
+	bool next(CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, bool argDownloaded,
+		CSELIB::FILEIO_LENGTH_T argPartSize, int argMaxParts, CSELIB::UTC_MILLIS_T argFetchMillis,
+		CSELIB::FILEIO_OFFSET_T* pBegin, CSELIB::FILEIO_OFFSET_T* pEnd);
+
+	void addFilePart(const std::shared_ptr<ReadFilePartType>& argFilePart);
+	void cancel();
+
+	std::wstring str() const;
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
@@ -15,15 +15,35 @@ std::wstring RuntimeEnv::str() const
     KeepLastError _keep;
 
     return JoinStrings(std::initializer_list{
+        KV_BOOL(AsyncRead),
         KV_FSSTR(CacheDataDir),
         KV_TO_WSTR(CacheFileRetentionMin),
         KV_FSSTR(CacheReportDir),
+        KV_TO_WSTR(ColdCacheAdmitMinKib),
+        KV_FSSTR(ColdCacheDir),
+        KV_TO_WSTR(ColdCacheSizeGiB),
         KV_TO_WSTR(DefaultCommonPrefixTime),
         KV_TO_WSTR(DefaultFileAttributes),
         KV_TO_WSTR(DeleteAfterUpload),
         KV_TO_WSTR(DeleteDirCondition),
+        KV_TO_WSTR(HeadTailPrefetchKib),
+        KV_TO_WSTR(MappedViewSizeMib),
+        KV_TO_WSTR(MaxCacheSizeGiB),
+        KV_TO_WSTR(MemoryCacheSizeMib),
+        KV_TO_WSTR(PrefetchDirBudgetMib),
+        KV_TO_WSTR(PrefetchFileMaxSizeKib),
+        KV_TO_WSTR(ReadAheadMaxParts),
         KV_BOOL(ReadOnly),
-        KV_TO_WSTR(TransferReadSizeMib)
+        KV_FSSTR(SharedCacheDir),
+        KV_TO_WSTR(StreamReadMinSizeMib),
+        KV_TO_WSTR(StreamReadRingParts),
+        KV_BOOL(StreamUpload),
+        KV_BOOL(TransferAutoTune),
+        KV_TO_WSTR(TransferMaxParallel),
+        KV_TO_WSTR(TransferMaxSizeMib),
+        KV_TO_WSTR(TransferMinSizeMib),
+        KV_TO_WSTR(TransferReadSizeMib),
+        KV_TO_WSTR(WriteBackDelaySec)
         }, L", ", true);
 }
 
@@ -8,43 +8,103 @@ namespace CSEDRV
 struct RuntimeEnv final
 {
 	explicit RuntimeEnv(
+		bool								argAsyncRead,
 		const std::filesystem::path&		argCacheDataDir,
 		int									argCacheFileRetentionMin,
 		const std::filesystem::path&		argCacheReportDir,
+		int									argColdCacheAdmitMinKib,
+		const std::filesystem::path&		argColdCacheDir,
+		int									argColdCacheSizeGiB,
 		CSELIB::FILETIME_100NS_T			argDefaultCommonPrefixTime,
 		UINT32								argDefaultFileAttributes,
 		int									argDeleteAfterUpload,
 		int									argDeleteDirCondition,
 		CSELIB::FileHandle&&				argDirSecurityRef,
 		CSELIB::FileHandle&&				argFileSecurityRef,
+		int									argHeadTailPrefetchKib,
+		int									argMappedViewSizeMib,
+		int									argMaxCacheSizeGiB,
+		int									argMemoryCacheSizeMib,
+		int									argPrefetchDirBudgetMib,
+		int									argPrefetchFileMaxSizeKib,
+		int									argReadAheadMaxParts,
 		bool								argReadOnly,
-		int									argTransferReadSizeMib)
+		const std::filesystem::path&		argSharedCacheDir,
+		int									argStreamReadMinSizeMib,
+		int									argStreamReadRingParts,
+		bool								argStreamUpload,
+		bool								argTransferAutoTune,
+		int									argTransferMaxParallel,
+		int									argTransferMaxSizeMib,
+		int									argTransferMinSizeMib,
+		int									argTransferReadSizeMib,
+		int									argWriteBackDelaySec)
 		:
+		AsyncRead							(argAsyncRead),
 		CacheDataDir						(argCacheDataDir),
 		CacheFileRetentionMin				(argCacheFileRetentionMin),
 		CacheReportDir						(argCacheReportDir),
+		ColdCacheAdmitMinKib				(argColdCacheAdmitMinKib),
+		ColdCacheDir						(argColdCacheDir),
+		ColdCacheSizeGiB					(argColdCacheSizeGiB),
 		DefaultCommonPrefixTime				(argDefaultCommonPrefixTime),
 		DefaultFileAttributes				(argDefaultFileAttributes),
 		DeleteAfterUpload					(argDeleteAfterUpload),
 		DeleteDirCondition					(argDeleteDirCondition),
 		DirSecurityRef						(std::move(argDirSecurityRef)),
 		FileSecurityRef						(std::move(argFileSecurityRef)),
+		HeadTailPrefetchKib					(argHeadTailPrefetchKib),
+		MappedViewSizeMib					(argMappedViewSizeMib),
+		MaxCacheSizeGiB						(argMaxCacheSizeGiB),
+		MemoryCacheSizeMib					(argMemoryCacheSizeMib),
+		PrefetchDirBudgetMib				(argPrefetchDirBudgetMib),
+		PrefetchFileMaxSizeKib				(argPrefetchFileMaxSizeKib),
+		ReadAheadMaxParts					(argReadAheadMaxParts),
 		ReadOnly							(argReadOnly),
-		TransferReadSizeMib					(argTransferReadSizeMib)
+		SharedCacheDir						(argSharedCacheDir),
+		StreamReadMinSizeMib				(argStreamReadMinSizeMib),
+		StreamReadRingParts					(argStreamReadRingParts),
+		StreamUpload						(argStreamUpload),
+		TransferAutoTune					(argTransferAutoTune),
+		TransferMaxParallel					(argTransferMaxParallel),
+		TransferMaxSizeMib					(argTransferMaxSizeMib),
+		TransferMinSizeMib					(argTransferMinSizeMib),
+		TransferReadSizeMib					(argTransferReadSizeMib),
+		WriteBackDelaySec					(argWriteBackDelaySec)
 	{
 	}
 
+	const bool								AsyncRead;
 	const std::filesystem::path				CacheDataDir;
 	const int								CacheFileRetentionMin;
 	const std::filesystem::path				CacheReportDir;
+	const int								ColdCacheAdmitMinKib;
+	const std::filesystem::path				ColdCacheDir;
+	const int								ColdCacheSizeGiB;
 	const CSELIB::FILETIME_100NS_T			DefaultCommonPrefixTime;
 	const UINT32							DefaultFileAttributes;
 	const int								DeleteAfterUpload;
 	const int								DeleteDirCondition;
 	const CSELIB::FileHandle				DirSecurityRef;
 	const CSELIB::FileHandle				FileSecurityRef;
+	const int								HeadTailPrefetchKib;
+	const int								MappedViewSizeMib;
+	const int								MaxCacheSizeGiB;
+	const int								MemoryCacheSizeMib;
+	const int								PrefetchDirBudgetMib;
+	const int								PrefetchFileMaxSizeKib;
+	const int								ReadAheadMaxParts;
 	const bool								ReadOnly;
+	const std::filesystem::path				SharedCacheDir;
+	const int								StreamReadMinSizeMib;
+	const int								StreamReadRingParts;
+	const bool								StreamUpload;
+	const bool								TransferAutoTune;
+	const int								TransferMaxParallel;
+	const int								TransferMaxSizeMib;
+	const int								TransferMinSizeMib;
 	const int								TransferReadSizeMib;
+	const int								WriteBackDelaySec;
 
 	std::wstring str() const;
 };
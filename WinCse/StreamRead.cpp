@@ -0,0 +1,165 @@
+#include "StreamRead.hpp"
+
+using namespace CSELIB;
+
+namespace CSEDRV {
+
+void StreamRead::interrupt()
+{
+    // s̃p[g̓obt@LĂ̂ŁA҂Kv͂Ȃ
+
+    for (const auto& filePart: mParts)
+    {
+        filePart->mInterrupt = true;
+    }
+
+    mParts.clear();
+}
+
+bool StreamRead::accept(FILEIO_OFFSET_T argOffset, bool argEligible)
+{
+    if (mDisabled)
+    {
+        return false;
+    }
+
+    if (mActive)
+    {
+        if (argEligible && argOffset == mNextOffset)
+        {
+            return true;
+        }
+
+        // AȂ Read t@C̕ύX̂ŁAȍ~̓LbVt@CoR
+
+        this->cancel();
+
+        return false;
+    }
+
+    if (!argEligible || argOffset != 0)
+    {
+        return false;
+    }
+
+    // 擪 Read ŊJn
+
+    mActive = true;
+    mNextOffset = 0LL;
+    mIssuedEnd = 0LL;
+
+    return true;
+}
+
+std::list<std::shared_ptr<StreamFilePart>> StreamRead::fill(FILEIO_OFFSET_T argReadEnd, FILESIZE_T argFileSize,
+    FILEIO_LENGTH_T argPartSize, int argRingParts)
+{
+    APP_ASSERT(mActive);
+    APP_ASSERT(argPartSize > 0);
+
+    std::list<std::shared_ptr<StreamFilePart>> fileParts;
+
+    // Read ͈̔͂܂ł͕KAȍ~̓p[g̏܂œo^
+
+    while (mIssuedEnd < argFileSize && (mIssuedEnd < argReadEnd || mParts.size() < static_cast<size_t>(argRingParts)))
+    {
+        const auto partLength = min(argPartSize, argFileSize - mIssuedEnd);
+
+        std::vector<BYTE> buffer;
+
+        if (!mFreeBuffers.empty())
+        {
+            buffer = std::move(mFreeBuffers.front());
+            mFreeBuffers.pop_front();
+        }
+
+        const auto filePart{ std::make_shared<StreamFilePart>(++mPartNumber, mIssuedEnd, partLength, std::move(buffer)) };
+
+        mParts.push_back(filePart);
+        fileParts.push_back(filePart);
+
+        mIssuedEnd += partLength;
+    }
+
+    return fileParts;
+}
+
+FILEIO_LENGTH_T StreamRead::read(FILEIO_OFFSET_T argOffset, PVOID argBuffer, FILEIO_LENGTH_T argLength)
+{
+    APP_ASSERT(mActive);
+    APP_ASSERT(argOffset == mNextOffset);
+
+    const auto readEnd = argOffset + argLength;
+
+    auto* dst = static_cast<BYTE*>(argBuffer);
+    auto pos = argOffset;
+
+    while (pos < readEnd)
+    {
+        if (mParts.empty())
+        {
+            this->cancel();
+            return -1LL;
+        }
+
+        const auto filePart{ mParts.front() };
+
+        APP_ASSERT(filePart->mOffset <= pos);
+
+        // p[g̎擾I܂ő҂
+
+        if (filePart->getResult() != filePart->mLength)
+        {
+            this->cancel();
+            return -1LL;
+        }
+
+        const auto partEnd = filePart->mOffset + filePart->mLength;
+        const auto copyLength = min(readEnd, partEnd) - pos;
+
+        memcpy(dst, filePart->mBuffer.data() + (pos - filePart->mOffset), static_cast<size_t>(copyLength));
+
+        dst += copyLength;
+        pos += copyLength;
+
+        if (partEnd <= pos)
+        {
+            // Ip[g̃obt@͎̃p[gŎg
+
+            mFreeBuffers.push_back(std::move(filePart->mBuffer));
+            mParts.pop_front();
+        }
+    }
+
+    mNextOffset = readEnd;
+
+    return argLength;
+}
+
+void StreamRead::cancel()
+{
+    this->interrupt();
+
+    mFreeBuffers.clear();
+
+    mActive = false;
+    mDisabled = true;
+}
+
+std::wstring StreamRead::str() const
+{
+    std::wostringstream ss;
+
+    ss << L"mSequentialOnly=" << BOOL_CSTRW(mSequentialOnly);
+    ss << L" mActive=" << BOOL_CSTRW(mActive);
+    ss << L" mDisabled=" << BOOL_CSTRW(mDisabled);
+    ss << L" mNextOffset=" << mNextOffset;
+    ss << L" mIssuedEnd=" << mIssuedEnd;
+    ss << L" mParts.size=" << mParts.size();
+
+    return ss.str();
+}
+
+}   // namespace CSEDRV
+
+// EOF
\ No newline at end of file
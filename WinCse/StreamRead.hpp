@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+namespace CSEDRV
+{
+
+//
+// LbVt@CoRȂ Read ̏
+//
+// ȃt@C擪xǂނ悤ȏꍇ (obNAbvȂ) ́ALbV
+// t@CɏłǂݒƃfBXN I/O {ɂȂÃLbV
+// ǂoĂ܂B
+// ̂߁A[g擾ẽp[gɎ󂯎ARead ̃obt@
+// ڃRs[Bp[g̐ɂ͏Ap[g̃obt@͎̃p[g
+// ėpB
+//
+// R[obN̓t@CɃbNĂ̂ŁAr͍sȂ
+//
+
+class StreamFilePart final : public ReadFilePartType
+{
+public:
+	std::vector<BYTE> mBuffer;
+
+	StreamFilePart(int argPartNumber, CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, std::vector<BYTE>&& argBuffer)
+		:
+		ReadFilePartType(argPartNumber, argOffset, argLength, -1LL),
+		mBuffer(std::move(argBuffer))
+	{
+		mBuffer.resize(static_cast<size_t>(argLength));
+	}
+};
+
+class StreamRead final
+{
+	// FILE_SEQUENTIAL_ONLY ŊJꂽ
+
+	bool mSequentialOnly = false;
+
+	bool mActive = false;
+
+	// AȂ Read ̂ŁÃReLXgł͗pȂ
+
+	bool mDisabled = false;
+
+	// Ɋ҂ Read ̈ʒu
+
+	CSELIB::FILEIO_OFFSET_T mNextOffset = 0LL;
+
+	// 擾o^͈͂̏I[
+
+	CSELIB::FILEIO_OFFSET_T mIssuedEnd = 0LL;
+
+	int mPartNumber = 0;
+
+	// 擾܂͎擾ς̃p[g (擪łO)
+
+	std::list<std::shared_ptr<StreamFilePart>> mParts;
+
+	// ėpobt@
+
+	std::list<std::vector<BYTE>> mFreeBuffers;
+
+	void interrupt();
+
+public:
+	~StreamRead()
+	{
+		this->interrupt();
+	}
+
+	void setSequentialOnly(bool argSequentialOnly)
+	{
+		mSequentialOnly = argSequentialOnly;
+	}
+
+	bool isSequentialOnly() const
+	{
+		return mSequentialOnly;
+	}
+
+	bool isActive() const
+	{
+		return mActive;
+	}
+
+	bool accept(CSELIB::FILEIO_OFFSET_T argOffset, bool argEligible);
+
+	std::list<std::shared_ptr<StreamFilePart>> fill(CSELIB::FILEIO_OFFSET_T argReadEnd, CSELIB::FILESIZE_T argFileSize,
+		CSELIB::FILEIO_LENGTH_T argPartSize, int argRingParts);
+
+	CSELIB::FILEIO_LENGTH_T read(CSELIB::FILEIO_OFFSET_T argOffset, PVOID argBuffer, CSELIB::FILEIO_LENGTH_T argLength);
+
+	void cancel();
+
+	std::wstring str() const;
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
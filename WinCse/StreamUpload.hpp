@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CSDriverInternal.h"
+
+namespace CSEDRV
+{
+
+//
+// 쐬܂͐؂l߂t@CA݂ƕsăAbv[h
+//
+// 擪Aď܂ĂԂ͏ݍς݂̒foCXɒʒmAp[gTCY
+// Bɑ点BN[Yɂ͎c̕𑗂ĊB
+//
+// 擪̘A݂łȂȂƂ (߂؂l߁Ãnh̕ύX) 
+// Abv[h𒆒fAN[Yɏ]ʂŜAbv[h
+//
+
+class StreamUpload final
+{
+	mutable std::mutex mGuard;
+
+	std::unique_ptr<CSELIB::IStreamUpload> mUpload;
+
+	// 擪Aď܂ꂽ
+
+	CSELIB::FILEIO_LENGTH_T mWrittenLength = 0LL;
+
+public:
+	explicit StreamUpload(std::unique_ptr<CSELIB::IStreamUpload>&& argUpload)
+		:
+		mUpload(std::move(argUpload))
+	{
+	}
+
+	bool active() const
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		return mUpload != nullptr;
+	}
+
+	// ȏ̃p[g𑗂n߂Ă
+
+	bool started() const
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		return mUpload && mUpload->started();
+	}
+
+	// 񂾔͈͂ʒm
+	// --> ŏ̃p[gɒBƂ̓}`p[gEAbv[h̊Jn҂
+
+	void write(CALLER_ARG CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength)
+	{
+		std::unique_ptr<CSELIB::IStreamUpload> cancelled;
+
+		{
+			std::lock_guard<std::mutex> lock_{ mGuard };
+
+			if (!mUpload)
+			{
+				return;
+			}
+
+			if (argOffset == mWrittenLength)
+			{
+				mWrittenLength += argLength;
+
+				if (mUpload->advance(CONT_CALLER mWrittenLength))
+				{
+					return;
+				}
+			}
+
+			cancelled = std::move(mUpload);
+		}
+
+		// f̃NGXg̓bN̊Oōs
+	}
+
+	// Mς̃p[gύX؂l߂͒f
+
+	void truncate(CSELIB::FILESIZE_T argFileSize)
+	{
+		std::unique_ptr<CSELIB::IStreamUpload> cancelled;
+
+		{
+			std::lock_guard<std::mutex> lock_{ mGuard };
+
+			if (argFileSize >= mWrittenLength)
+			{
+				return;
+			}
+
+			cancelled = std::move(mUpload);
+		}
+	}
+
+	void cancel()
+	{
+		std::unique_ptr<CSELIB::IStreamUpload> cancelled;
+
+		{
+			std::lock_guard<std::mutex> lock_{ mGuard };
+
+			cancelled = std::move(mUpload);
+		}
+	}
+
+	// N[YɎc𑗂Ċ
+
+	std::unique_ptr<CSELIB::IStreamUpload> release()
+	{
+		std::lock_guard<std::mutex> lock_{ mGuard };
+
+		return std::move(mUpload);
+	}
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
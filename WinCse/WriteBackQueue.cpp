@@ -0,0 +1,587 @@
+#include "WriteBackQueue.hpp"
+
+using namespace CSELIB;
+
+// }NɂKv͂ȂA킩₷̂
+
+#if defined(THREAD_SAFE)
+#error "THREAD_SAFFE(): already defined"
+#endif
+
+#define THREAD_SAFE()       std::lock_guard<std::mutex> lock_{ mGuard }
+
+// W[i̓t@CEwb_̌ɃGg̃R[h
+// ͏Ȃ̂ŁAύX̓sxŜ
+
+static const UINT32 WRITE_BACK_SIGNATURE = 0x31425757;  // "WWB1"
+
+struct WriteBackFileHeader
+{
+    UINT32      mSignature;
+    UINT32      mReserved;
+};
+
+// ̌ Windows ̃pXALbVt@C (΃pX)AύXO ETag 
+
+struct WriteBackRecord
+{
+    FSP_FSCTL_FILE_INFO mFileInfo;
+    UINT32              mWinPathLength;
+    UINT32              mCacheFileNameLength;
+    UINT32              mETagLength;
+    UINT32              mReserved;
+};
+
+// Abv[hɎsƂ̍Ďs̊Ԋu (sxɔ{ɂ)
+
+static const UTC_MILLIS_T RETRY_MIN_MILLIS = TIMEMILLIS_1SECull * 30;
+static const UTC_MILLIS_T RETRY_MAX_MILLIS = TIMEMILLIS_1MINull * 30;
+
+static std::wstring getEntryETag(const CSEDRV::WriteBackQueue::Entry& argEntry)
+{
+    const auto it{ argEntry.mDirEntry->mUserProperties.find(L"wincse-etag") };
+
+    return it == argEntry.mDirEntry->mUserProperties.cend() ? L"" : it->second;
+}
+
+namespace CSEDRV {
+
+bool WriteBackQueue::open(const std::filesystem::path& argCacheDataDir)
+{
+    NEW_LOG_BLOCK();
+
+    THREAD_SAFE();
+
+    mCacheDataDir = argCacheDataDir;
+    mMap.clear();
+
+    const auto journalPath{ mCacheDataDir / WRITE_BACK_QUEUE_FNAME };
+
+    if (::GetFileAttributesW(journalPath.c_str()) != INVALID_FILE_ATTRIBUTES)
+    {
+        if (!this->loadJournal(journalPath))
+        {
+            errorW(L"fault: loadJournal journalPath=%s", journalPath.c_str());
+
+            mMap.clear();
+        }
+    }
+
+    // LbVt@Cꂽ̂̓Abv[hłȂ
+
+    const auto nowMillis = GetCurrentUtcMillis();
+
+    for (auto it=mMap.begin(); it!=mMap.end(); )
+    {
+        if (::GetFileAttributesW(it->second.mCacheFilePath.c_str()) == INVALID_FILE_ATTRIBUTES)
+        {
+            errorW(L"fault: lost winPath=%s mCacheFilePath=%s", it->first.c_str(), it->second.mCacheFilePath.c_str());
+
+            it = mMap.erase(it);
+        }
+        else
+        {
+            // O̒~OɃN[YĂ̂ŁAɃAbv[h
+
+            it->second.mDueMillis = nowMillis;
+
+            ++it;
+        }
+    }
+
+    traceW(L"mMap.size=%zu", mMap.size());
+
+    return this->rewriteJournal();
+}
+
+bool WriteBackQueue::loadJournal(const std::filesystem::path& argJournalPath)
+{
+    NEW_LOG_BLOCK();
+
+    FileHandle file = ::CreateFileW(
+        argJournalPath.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (file.invalid())
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: CreateFileW lerr=%lu argJournalPath=%s", lerr, argJournalPath.c_str());
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+
+    if (!::GetFileSizeEx(file.handle(), &fileSize) || fileSize.QuadPart > MAXDWORD)
+    {
+        errorW(L"fault: GetFileSizeEx argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    std::vector<BYTE> buffer(static_cast<size_t>(fileSize.QuadPart));
+    DWORD bytesRead = 0;
+
+    if (!::ReadFile(file.handle(), buffer.data(), static_cast<DWORD>(buffer.size()), &bytesRead, NULL) || bytesRead != buffer.size())
+    {
+        errorW(L"fault: ReadFile argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    const auto* pos = buffer.data();
+    const auto* const end = buffer.data() + buffer.size();
+
+    WriteBackFileHeader fileHeader;
+
+    if (static_cast<size_t>(end - pos) < sizeof(fileHeader))
+    {
+        errorW(L"fault: too short argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    memcpy(&fileHeader, pos, sizeof(fileHeader));
+    pos += sizeof(fileHeader);
+
+    if (fileHeader.mSignature != WRITE_BACK_SIGNATURE)
+    {
+        errorW(L"fault: invalid signature argJournalPath=%s", argJournalPath.c_str());
+        return false;
+    }
+
+    while (pos < end)
+    {
+        WriteBackRecord record;
+
+        if (static_cast<size_t>(end - pos) < sizeof(record))
+        {
+            errorW(L"fault: invalid record offset=%zu", static_cast<size_t>(pos - buffer.data()));
+            return false;
+        }
+
+        memcpy(&record, pos, sizeof(record));
+        pos += sizeof(record);
+
+        std::wstring winPath;
+        std::wstring cacheFileName;
+        std::wstring etag;
+
+        if (!ReadStringFromBuffer(pos, end, record.mWinPathLength, &winPath))
+        {
+            errorW(L"fault: ReadStringFromBuffer winPath");
+            return false;
+        }
+
+        pos += winPath.size() * sizeof(wchar_t);
+
+        if (!ReadStringFromBuffer(pos, end, record.mCacheFileNameLength, &cacheFileName))
+        {
+            errorW(L"fault: ReadStringFromBuffer cacheFileName");
+            return false;
+        }
+
+        pos += cacheFileName.size() * sizeof(wchar_t);
+
+        if (!ReadStringFromBuffer(pos, end, record.mETagLength, &etag))
+        {
+            errorW(L"fault: ReadStringFromBuffer etag");
+            return false;
+        }
+
+        pos += etag.size() * sizeof(wchar_t);
+
+        // ύXO ETag ƃN[Y̑fBNgGg𕜌
+
+        const auto& fileInfo{ record.mFileInfo };
+
+        Entry entry;
+
+        entry.mDirEntry = DirectoryEntry::makeFileEntry(std::filesystem::path{ winPath }.filename().wstring(),
+            fileInfo.FileSize, fileInfo.CreationTime, fileInfo.LastAccessTime, fileInfo.LastWriteTime, fileInfo.ChangeTime);
+
+        entry.mDirEntry->mFileInfo = fileInfo;
+
+        if (!etag.empty())
+        {
+            entry.mDirEntry->mUserProperties[L"wincse-etag"] = etag;
+        }
+
+        entry.mCacheFilePath = mCacheDataDir / cacheFileName;
+
+        traceW(L"winPath=%s mDirEntry=%s", winPath.c_str(), entry.mDirEntry->str().c_str());
+
+        mMap[winPath] = std::move(entry);
+    }
+
+    return true;
+}
+
+bool WriteBackQueue::rewriteJournal() const
+{
+    NEW_LOG_BLOCK();
+
+    // ꎞt@CɏoĂu
+
+    const auto journalPath{ mCacheDataDir / WRITE_BACK_QUEUE_FNAME };
+    const auto tempPath{ journalPath.wstring() + L".tmp" };
+
+    if (mMap.empty())
+    {
+        if (!::DeleteFileW(journalPath.c_str()))
+        {
+            const auto lerr = ::GetLastError();
+
+            if (lerr != ERROR_FILE_NOT_FOUND)
+            {
+                errorW(L"fault: DeleteFileW lerr=%lu journalPath=%s", lerr, journalPath.c_str());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<BYTE> buffer;
+
+    const WriteBackFileHeader fileHeader{ WRITE_BACK_SIGNATURE, 0 };
+
+    AppendBytesToBuffer(&buffer, &fileHeader, sizeof(fileHeader));
+
+    for (const auto& it: mMap)
+    {
+        const auto& winPath{ it.first };
+        const auto cacheFileName{ it.second.mCacheFilePath.lexically_relative(mCacheDataDir).wstring() };
+        const auto etag{ getEntryETag(it.second) };
+
+        const WriteBackRecord record
+        {
+            it.second.mDirEntry->mFileInfo,
+            static_cast<UINT32>(winPath.size()),
+            static_cast<UINT32>(cacheFileName.size()),
+            static_cast<UINT32>(etag.size()),
+            0
+        };
+
+        AppendBytesToBuffer(&buffer, &record, sizeof(record));
+        AppendBytesToBuffer(&buffer, winPath.data(), winPath.size() * sizeof(wchar_t));
+        AppendBytesToBuffer(&buffer, cacheFileName.data(), cacheFileName.size() * sizeof(wchar_t));
+        AppendBytesToBuffer(&buffer, etag.data(), etag.size() * sizeof(wchar_t));
+    }
+
+    {
+        FileHandle file = ::CreateFileW(
+            tempPath.c_str(),
+            GENERIC_WRITE,
+            0,
+            NULL,
+            CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            NULL);
+
+        if (file.invalid())
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: CreateFileW lerr=%lu tempPath=%s", lerr, tempPath.c_str());
+            return false;
+        }
+
+        DWORD bytesWritten = 0;
+
+        if (!::WriteFile(file.handle(), buffer.data(), static_cast<DWORD>(buffer.size()), &bytesWritten, NULL) || bytesWritten != buffer.size())
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: WriteFile lerr=%lu tempPath=%s", lerr, tempPath.c_str());
+            return false;
+        }
+
+        // N[Yɒ~ĂȂ悤
+
+        if (!::FlushFileBuffers(file.handle()))
+        {
+            const auto lerr = ::GetLastError();
+
+            errorW(L"fault: FlushFileBuffers lerr=%lu tempPath=%s", lerr, tempPath.c_str());
+            return false;
+        }
+    }
+
+    if (!::MoveFileExW(tempPath.c_str(), journalPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+    {
+        const auto lerr = ::GetLastError();
+
+        errorW(L"fault: MoveFileExW lerr=%lu tempPath=%s", lerr, tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void WriteBackQueue::start(UTC_MILLIS_T argDelayMillis, FlushCallback&& argFlush)
+{
+    NEW_LOG_BLOCK();
+
+    {
+        THREAD_SAFE();
+
+        mDelayMillis = argDelayMillis;
+        mFlush = std::move(argFlush);
+        mEndThreadFlag = false;
+    }
+
+    traceW(L"start WriteBack thread mDelayMillis=%llu", argDelayMillis);
+
+    mThread = std::make_unique<std::thread>(&WriteBackQueue::run, this);
+    APP_ASSERT(mThread);
+
+    const auto hresult = ::SetThreadDescription(mThread->native_handle(), L"WriteBackQueue::run");
+    APP_ASSERT(SUCCEEDED(hresult));
+}
+
+void WriteBackQueue::stop()
+{
+    NEW_LOG_BLOCK();
+
+    {
+        THREAD_SAFE();
+
+        mEndThreadFlag = true;
+    }
+
+    mCond.notify_all();
+
+    if (mThread)
+    {
+        traceW(L"join thread");
+        mThread->join();
+
+        mThread.reset();
+    }
+}
+
+void WriteBackQueue::run()
+{
+    NEW_LOG_BLOCK();
+
+    std::unique_lock<std::mutex> lock{ mGuard };
+
+    while (!mEndThreadFlag)
+    {
+        // ҋ@ԂłI
+
+        const auto it = std::min_element(mMap.begin(), mMap.end(), [](const auto& l, const auto& r)
+        {
+            return l.second.mDueMillis < r.second.mDueMillis;
+        });
+
+        if (it == mMap.end())
+        {
+            mCond.wait(lock);
+            continue;
+        }
+
+        const auto nowMillis = GetCurrentUtcMillis();
+
+        if (nowMillis < it->second.mDueMillis)
+        {
+            mCond.wait_for(lock, std::chrono::milliseconds(it->second.mDueMillis - nowMillis));
+            continue;
+        }
+
+        // ʂ remove()  reschedule() Ŕf邪AȂƂ̂߂
+        // ̎ݒ肵Ă
+
+        it->second.mDueMillis = nowMillis + RETRY_MIN_MILLIS;
+
+        const auto winPath{ it->first };
+
+        lock.unlock();
+
+        traceW(L"flush winPath=%s", winPath.c_str());
+
+        mFlush(winPath);
+
+        lock.lock();
+    }
+
+    traceW(L"exit");
+}
+
+void WriteBackQueue::enqueue(const std::wstring& argWinPath, Entry&& argEntry)
+{
+    NEW_LOG_BLOCK();
+
+    THREAD_SAFE();
+
+    const auto it{ mMap.find(argWinPath) };
+    if (it != mMap.end())
+    {
+        // Abv[hOɍĂуN[Yꂽ
+        // --> O܂ł̕ύXKv̂ŁAύX͈͂킹
+
+        const auto& prevRanges{ it->second.mDirtyRanges };
+        auto& newRanges{ argEntry.mDirtyRanges };
+
+        if (prevRanges && newRanges && prevRanges->getETag() == newRanges->getETag())
+        {
+            newRanges->merge(*prevRanges);
+        }
+        else
+        {
+            newRanges.reset();
+        }
+
+        traceW(L"coalesce argWinPath=%s", argWinPath.c_str());
+    }
+
+    // Ō̃N[Yҋ@Ԃ蒼
+
+    argEntry.mDueMillis = GetCurrentUtcMillis() + mDelayMillis;
+    argEntry.mRetryCount = 0;
+    argEntry.mGeneration = ++mLastGeneration;
+
+    mMap[argWinPath] = std::move(argEntry);
+
+    if (!this->rewriteJournal())
+    {
+        errorW(L"fault: rewriteJournal argWinPath=%s", argWinPath.c_str());
+    }
+
+    mCond.notify_one();
+}
+
+bool WriteBackQueue::get(const std::wstring& argWinPath, Entry* pEntry) const
+{
+    THREAD_SAFE();
+
+    const auto it{ mMap.find(argWinPath) };
+    if (it == mMap.cend())
+    {
+        return false;
+    }
+
+    if (pEntry)
+    {
+        *pEntry = it->second;
+    }
+
+    return true;
+}
+
+bool WriteBackQueue::remove(const std::wstring& argWinPath)
+{
+    NEW_LOG_BLOCK();
+
+    THREAD_SAFE();
+
+    if (mMap.erase(argWinPath) == 0)
+    {
+        return false;
+    }
+
+    if (!this->rewriteJournal())
+    {
+        errorW(L"fault: rewriteJournal argWinPath=%s", argWinPath.c_str());
+    }
+
+    return true;
+}
+
+void WriteBackQueue::reschedule(const std::wstring& argWinPath, bool argFailed)
+{
+    NEW_LOG_BLOCK();
+
+    THREAD_SAFE();
+
+    const auto it{ mMap.find(argWinPath) };
+    if (it == mMap.end())
+    {
+        return;
+    }
+
+    auto& entry{ it->second };
+
+    auto delayMillis = mDelayMillis;
+
+    if (argFailed)
+    {
+        // sƂ̓[gɕׂȂ悤ɊԊuL
+
+        delayMillis = min(RETRY_MIN_MILLIS << min(entry.mRetryCount, 6), RETRY_MAX_MILLIS);
+
+        entry.mRetryCount++;
+    }
+
+    entry.mDueMillis = GetCurrentUtcMillis() + delayMillis;
+
+    traceW(L"argWinPath=%s mRetryCount=%d delayMillis=%llu", argWinPath.c_str(), entry.mRetryCount, delayMillis);
+}
+
+bool WriteBackQueue::contains(const std::wstring& argWinPath) const
+{
+    return this->get(argWinPath, nullptr);
+}
+
+bool WriteBackQueue::containsCacheFile(const std::filesystem::path& argCacheFilePath) const
+{
+    THREAD_SAFE();
+
+    // pX̕\LقȂ邱Ƃ̂ŁAt@CŔr
+
+    const auto fileName{ argCacheFilePath.filename().wstring() };
+
+    return std::any_of(mMap.cbegin(), mMap.cend(), [&fileName](const auto& it)
+    {
+        return _wcsicmp(it.second.mCacheFilePath.filename().c_str(), fileName.c_str()) == 0;
+    });
+}
+
+WriteBackQueue::copy_type WriteBackQueue::copy_if(std::function<bool(const copy_type::value_type&)> callback) const
+{
+    THREAD_SAFE();
+
+    copy_type ret;
+
+    for (const auto& it: mMap)
+    {
+        const copy_type::value_type value{ it.first, it.second.mDirEntry };
+
+        if (callback(value))
+        {
+            ret.insert(value);
+        }
+    }
+
+    return ret;
+}
+
+std::list<std::wstring> WriteBackQueue::keys() const
+{
+    THREAD_SAFE();
+
+    std::list<std::wstring> ret;
+
+    for (const auto& it: mMap)
+    {
+        ret.push_back(it.first);
+    }
+
+    return ret;
+}
+
+size_t WriteBackQueue::size() const
+{
+    THREAD_SAFE();
+
+    return mMap.size();
+}
+
+}   // namespace CSEDRV
+
+#undef THREAD_SAFE
+
+// EOF
\ No newline at end of file
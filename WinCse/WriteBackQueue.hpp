@@ -0,0 +1,91 @@
+#pragma once
+
+#include <condition_variable>
+
+#include "CSDriverInternal.h"
+#include "CacheExtents.hpp"
+
+namespace CSEDRV
+{
+
+//
+// ύXꂽt@CN[YɃobNOEhŃAbv[h
+//
+// N[Yɂ̓Ggo^邾ŁAAbv[h͐p̃Xbhҋ@Ԃ
+// oߌɍsBҋ@ɓt@CĂуN[YƑҋ@Ԃ蒼̂ŁA
+// ۑJԂt@Cx̃Abv[hɂ܂Ƃ܂B
+//
+// Abv[h܂ł̓Gg̃fBNgGg[J̏Ԃ\B
+// Gg̓LbVEfBNg̃W[iɕۑAT[rX̍ċN
+// Abv[h
+//
+
+class WriteBackQueue final
+{
+public:
+	struct Entry
+	{
+		CSELIB::DirEntryType			mDirEntry;
+		std::filesystem::path			mCacheFilePath;
+
+		// ύX͈ (킩ȂƂ͑ŜAbv[h)
+		// --> W[iɂ͕ۑȂ̂ŁAċN͑ŜAbv[h
+
+		std::optional<CacheExtents>		mDirtyRanges;
+
+		CSELIB::UTC_MILLIS_T			mDueMillis = 0ULL;
+		int								mRetryCount = 0;
+
+		// o^Ƃɑԍ
+		// --> Abv[hɍĂѓo^ꂽǂ𔻒f
+
+		uint64_t						mGeneration = 0ULL;
+	};
+
+	using copy_type = std::map<std::filesystem::path, CSELIB::DirEntryType>;
+	using FlushCallback = std::function<void(const std::wstring&)>;
+
+private:
+	std::filesystem::path mCacheDataDir;
+	std::map<std::wstring, Entry> mMap;
+
+	CSELIB::UTC_MILLIS_T mDelayMillis = 0ULL;
+	uint64_t mLastGeneration = 0ULL;
+	FlushCallback mFlush;
+
+	std::unique_ptr<std::thread> mThread;
+	bool mEndThreadFlag = false;
+	std::condition_variable mCond;
+
+	mutable std::mutex mGuard;
+
+	bool loadJournal(const std::filesystem::path& argJournalPath);
+	bool rewriteJournal() const;
+	void run();
+
+public:
+	~WriteBackQueue()
+	{
+		this->stop();
+	}
+
+	bool open(const std::filesystem::path& argCacheDataDir);
+	void start(CSELIB::UTC_MILLIS_T argDelayMillis, FlushCallback&& argFlush);
+	void stop();
+
+	void enqueue(const std::wstring& argWinPath, Entry&& argEntry);
+	bool get(const std::wstring& argWinPath, Entry* pEntry) const;
+	bool remove(const std::wstring& argWinPath);
+	void reschedule(const std::wstring& argWinPath, bool argFailed);
+
+	bool contains(const std::wstring& argWinPath) const;
+	bool containsCacheFile(const std::filesystem::path& argCacheFilePath) const;
+	copy_type copy_if(std::function<bool(const copy_type::value_type&)> callback) const;
+	std::list<std::wstring> keys() const;
+
+	size_t size() const;
+};
+
+}	// namespace CSEDRV
+
+// EOF
\ No newline at end of file
@@ -32,6 +32,30 @@ bool IApiClient::DeleteObjects(CALLER_ARG const std::wstring& argBucket, const s
 	return true;
 }
 
+#pragma warning(suppress: 4100)
+bool IApiClient::PutObjectPartial(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath, const std::wstring& argSourceETag, const std::list<UploadRange>& argRanges)
+{
+	NEW_LOG_BLOCK();
+
+	// [g̓e𕔕IɃRs[łȂƂ́AĂяoőŜAbv[h
+
+	traceW(L"not supported argObjKey=%s", argObjKey.c_str());
+
+	return false;
+}
+
+#pragma warning(suppress: 4100)
+std::unique_ptr<IStreamUpload> IApiClient::BeginStreamUpload(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
+{
+	NEW_LOG_BLOCK();
+
+	// ݂ƕsăAbv[hłȂƂ́AN[YɑŜAbv[h
+
+	traceW(L"not supported argObjKey=%s", argObjKey.c_str());
+
+	return nullptr;
+}
+
 }	// namespace CSEDVC
 
 // EOF
\ No newline at end of file
@@ -93,13 +93,148 @@ CSELIB::FILEIO_LENGTH_T writeStreamFromFile(CALLER_ARG const std::ostream* argOu
     return argInputLength;
 }
 
+// lbg[N̎Mƃt@Cւ݂̏d˂邽߂̃obt@
+//
+// Mobt@݂̏񓯊ɊJnA҂Ɏ̃obt@
+// MBobt@Ė߂ĂƂɁAȌ݂̊҂
+
+constexpr int WRITE_PIPELINE_DEPTH = 4;
+
+struct OverlappedWriteSlot
+{
+    OVERLAPPED          mOverlapped{};
+    CSELIB::EventHandle mEvent;
+    char*               mBuffer = nullptr;
+    DWORD               mLength = 0;
+    bool                mPending = false;
+};
+
+struct OverlappedWriteBuffers
+{
+    char* mArena = nullptr;
+    OverlappedWriteSlot mSlots[WRITE_PIPELINE_DEPTH];
+
+    OverlappedWriteBuffers()
+    {
+        // y[WEɑĊmۂ
+
+        mArena = static_cast<char*>(::VirtualAlloc(NULL, CSELIB::FILEIO_BUFFER_SIZE * WRITE_PIPELINE_DEPTH, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+        if (!mArena)
+        {
+            return;
+        }
+
+        for (int i=0; i<WRITE_PIPELINE_DEPTH; i++)
+        {
+            mSlots[i].mBuffer = mArena + CSELIB::FILEIO_BUFFER_SIZE * i;
+            mSlots[i].mEvent = ::CreateEventW(NULL, TRUE, FALSE, NULL);
+        }
+    }
+
+    ~OverlappedWriteBuffers()
+    {
+        if (mArena)
+        {
+            ::VirtualFree(mArena, 0, MEM_RELEASE);
+        }
+    }
+
+    bool valid() const
+    {
+        if (!mArena)
+        {
+            return false;
+        }
+
+        for (const auto& slot: mSlots)
+        {
+            if (slot.mEvent.invalid())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+static bool startWrite(CALLER_ARG HANDLE argFile, OverlappedWriteSlot* pSlot, CSELIB::FILEIO_OFFSET_T argOffset, DWORD argLength)
+{
+    NEW_LOG_BLOCK();
+    APP_ASSERT(!pSlot->mPending);
+
+    LARGE_INTEGER li{};
+    li.QuadPart = argOffset;
+
+    pSlot->mOverlapped = OVERLAPPED{};
+    pSlot->mOverlapped.Offset = li.LowPart;
+    pSlot->mOverlapped.OffsetHigh = li.HighPart;
+    pSlot->mOverlapped.hEvent = pSlot->mEvent.handle();
+    pSlot->mLength = argLength;
+
+    if (!::WriteFile(argFile, pSlot->mBuffer, argLength, NULL, &pSlot->mOverlapped))
+    {
+        const auto lerr = ::GetLastError();
+        if (lerr != ERROR_IO_PENDING)
+        {
+            errorW(L"fault: WriteFile lerr=%lu argOffset=%lld argLength=%lu", lerr, argOffset, argLength);
+            return false;
+        }
+    }
+
+    // IɊꍇ̊mF completeWrite() ōs
+
+    pSlot->mPending = true;
+
+    return true;
+}
+
+static bool completeWrite(CALLER_ARG HANDLE argFile, OverlappedWriteSlot* pSlot)
+{
+    NEW_LOG_BLOCK();
+
+    if (!pSlot->mPending)
+    {
+        return true;
+    }
+
+    pSlot->mPending = false;
+
+    DWORD bytesWritten = 0;
+    if (!::GetOverlappedResult(argFile, &pSlot->mOverlapped, &bytesWritten, TRUE))
+    {
+        const auto lerr = ::GetLastError();
+        errorW(L"fault: GetOverlappedResult lerr=%lu", lerr);
+
+        return false;
+    }
+
+    if (bytesWritten != pSlot->mLength)
+    {
+        errorW(L"fault: bytesWritten=%lu mLength=%lu", bytesWritten, pSlot->mLength);
+        return false;
+    }
+
+    traceW(L"bytesWritten=%lu", bytesWritten);
+
+    return true;
+}
+
 CSELIB::FILEIO_LENGTH_T writeFileFromStream(CALLER_ARG
     const std::filesystem::path& argOutputPath, CSELIB::FILEIO_OFFSET_T argOutputOffset,
     const std::istream* argInputStream, CSELIB::FILEIO_LENGTH_T argInputLength)
 {
     NEW_LOG_BLOCK();
 
-    // t@CJ argOffset ̈ʒuɃ|C^ړ
+    static thread_local OverlappedWriteBuffers buffers;
+
+    if (!buffers.valid())
+    {
+        errorW(L"fault: OverlappedWriteBuffers");
+        return -1LL;
+    }
+
+    // t@C񓯊̏ݗpɊJ
 
     CSELIB::FileHandle file = ::CreateFileW
     (
@@ -108,7 +243,7 @@ CSELIB::FILEIO_LENGTH_T writeFileFromStream(CALLER_ARG
         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
         NULL,
         OPEN_EXISTING,
-        FILE_ATTRIBUTE_NORMAL,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
         NULL
     );
 
@@ -120,71 +255,145 @@ CSELIB::FILEIO_LENGTH_T writeFileFromStream(CALLER_ARG
         return -1LL;
     }
 
-    LARGE_INTEGER li{};
-    li.QuadPart = argOutputOffset;
+    // ̃nhł݂̏ł̓^CX^vXVȂ
+    // --> obNOEhł̎擾Ń[gƂ̓ԂȂ悤
 
-    if (::SetFilePointerEx(file.handle(), li, NULL, FILE_BEGIN) == 0)
+    FILETIME ftNoUpdate{ MAXDWORD, MAXDWORD };
+
+    if (!::SetFileTime(file.handle(), NULL, &ftNoUpdate, &ftNoUpdate))
     {
         const auto lerr = ::GetLastError();
-        errorW(L"fault: SetFilePointerEx lerr=%lu file=%s", lerr, file.str().c_str());
+        errorW(L"fault: SetFileTime lerr=%lu file=%s", lerr, file.str().c_str());
 
         return -1LL;
     }
 
     // 擾et@Cɏo
+    // --> ݂̊҂Ԃ̃obt@ւ̎Mi߂
 
     auto* pbuf = argInputStream->rdbuf();
     auto remainingTotal = argInputLength;
+    auto writeOffset = argOutputOffset;
+    const CSELIB::FILEIO_LENGTH_T bufferSize = CSELIB::FILEIO_BUFFER_SIZE;
 
-    static thread_local char buffer[CSELIB::FILEIO_BUFFER_SIZE];
-    const CSELIB::FILEIO_LENGTH_T bufferSize = _countof(buffer);
+    bool success = true;
+    int index = 0;
 
     while (remainingTotal > 0)
     {
+        auto* slot = &buffers.mSlots[index];
+
+        // O񂱂̗̈悩Jn݂̊҂
+
+        if (!completeWrite(CONT_CALLER file.handle(), slot))
+        {
+            errorW(L"fault: completeWrite");
+            success = false;
+            break;
+        }
+
         // obt@Ƀf[^ǂݍ
 
         if (!argInputStream->good())
         {
             errorW(L"fault: no good");
-            return -1LL;
+            success = false;
+            break;
         }
 
-        const auto bytesRead = pbuf->sgetn(buffer, min(remainingTotal, bufferSize));
+        const auto bytesRead = pbuf->sgetn(slot->mBuffer, min(remainingTotal, bufferSize));
         if (bytesRead <= 0)
         {
             errorW(L"fault: sgetn");
-            return -1LL;
+            success = false;
+            break;
         }
 
         traceW(L"bytesRead=%lld", bytesRead);
 
-        // t@CɃf[^
+        // t@Cւ݂̏Jn
 
-        auto* pos = buffer;
-        auto remainingWrite = bytesRead;
+        if (!startWrite(CONT_CALLER file.handle(), slot, writeOffset, static_cast<DWORD>(bytesRead)))
+        {
+            errorW(L"fault: startWrite");
+            success = false;
+            break;
+        }
 
-        while (remainingWrite > 0)
+        writeOffset += bytesRead;
+        remainingTotal -= bytesRead;
+
+        traceW(L"remainingTotal=%lld", remainingTotal);
+
+        index = (index + 1) % WRITE_PIPELINE_DEPTH;
+    }
+
+    if (!success)
+    {
+        // obt@ėpł悤ɁAs݂̏ďI҂
+
+        ::CancelIoEx(file.handle(), NULL);
+    }
+
+    for (auto& slot: buffers.mSlots)
+    {
+        if (!completeWrite(CONT_CALLER file.handle(), &slot))
         {
-            traceW(L"remainingWrite=%lld", remainingWrite);
+            errorW(L"fault: completeWrite");
+            success = false;
+        }
+    }
 
-            DWORD bytesWritten;
-            if (!::WriteFile(file.handle(), pos, static_cast<DWORD>(remainingWrite), &bytesWritten, NULL))
-            {
-                const auto lerr = ::GetLastError();
-                errorW(L"fault: WriteFile lerr=%lu", lerr);
+    if (!success)
+    {
+        return -1LL;
+    }
 
-                return -1LL;
-            }
+    // 擾ς͈̔͂ƂċL^OɁAefBXNɔf
+    // --> ُǏɁA܂ĂȂ͈͂擾ςƂĈȂ悤
 
-            pos += bytesWritten;
-            remainingWrite -= bytesWritten;
+    if (!::FlushFileBuffers(file.handle()))
+    {
+        const auto lerr = ::GetLastError();
+        errorW(L"fault: FlushFileBuffers lerr=%lu file=%s", lerr, file.str().c_str());
+
+        return -1LL;
+    }
 
-            traceW(L"bytesWritten=%lu remainingWrite=%lld", bytesWritten, remainingWrite);
+    return argInputLength;
+}
+
+CSELIB::FILEIO_LENGTH_T writeBufferFromStream(CALLER_ARG
+    PVOID argOutputBuffer,
+    const std::istream* argInputStream, CSELIB::FILEIO_LENGTH_T argInputLength)
+{
+    NEW_LOG_BLOCK();
+
+    // 擾e𒆊ԃobt@oRɏo͐ɓǂݍ
+
+    auto* pbuf = argInputStream->rdbuf();
+    auto* pos = static_cast<char*>(argOutputBuffer);
+    auto remainingTotal = argInputLength;
+
+    while (remainingTotal > 0)
+    {
+        if (!argInputStream->good())
+        {
+            errorW(L"fault: no good");
+            return -1LL;
+        }
+
+        const auto bytesRead = pbuf->sgetn(pos, remainingTotal);
+        if (bytesRead <= 0)
+        {
+            errorW(L"fault: sgetn");
+            return -1LL;
         }
 
+        pos += bytesRead;
         remainingTotal -= bytesRead;
 
-        traceW(L"remainingTotal=%lld", remainingTotal);
+        traceW(L"bytesRead=%lld remainingTotal=%lld", bytesRead, remainingTotal);
     }
 
     return argInputLength;
@@ -438,9 +647,37 @@ bool CSDevice::listObjects(CALLER_ARG const CSELIB::ObjectKey& argObjKey, CSELIB
 }
 
 FILEIO_LENGTH_T CSDevice::getObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey,
-    const std::filesystem::path& argOutputPath, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength)
+    const std::filesystem::path& argOutputPath, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag)
 {
-    return mApiClient->GetObjectAndWriteFile(CONT_CALLER argObjKey, argOutputPath, argOffset, argLength);
+    NEW_LOG_BLOCK();
+
+    const auto ret = mApiClient->GetObjectAndWriteFile(CONT_CALLER argObjKey, argOutputPath, argOffset, argLength, argETag);
+
+    if (ret == FILEIO_LENGTH_ETAG_MISMATCH)
+    {
+        // [gXVĂ̂ŁALbVĂ͌Â
+
+        const auto num = mQueryObject->qoDeleteCache(CONT_CALLER argObjKey);
+        traceW(L"etag mismatch, cache delete num=%d argObjKey=%s", num, argObjKey.c_str());
+    }
+
+    return ret;
+}
+
+FILEIO_LENGTH_T CSDevice::getObjectAndWriteBuffer(CALLER_ARG const CSELIB::ObjectKey& argObjKey,
+    PVOID argOutputBuffer, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag)
+{
+    NEW_LOG_BLOCK();
+
+    const auto ret = mApiClient->GetObjectAndWriteBuffer(CONT_CALLER argObjKey, argOutputBuffer, argOffset, argLength, argETag);
+
+    if (ret == FILEIO_LENGTH_ETAG_MISMATCH)
+    {
+        const auto num = mQueryObject->qoDeleteCache(CONT_CALLER argObjKey);
+        traceW(L"etag mismatch, cache delete num=%d argObjKey=%s", num, argObjKey.c_str());
+    }
+
+    return ret;
 }
 
 bool CSDevice::putObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
@@ -461,6 +698,48 @@ bool CSDevice::putObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FS
     return true;
 }
 
+bool CSDevice::putObjectPartial(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath, const std::wstring& argSourceETag, const std::list<CSELIB::UploadRange>& argRanges)
+{
+    NEW_LOG_BLOCK();
+
+    if (!mApiClient->PutObjectPartial(CONT_CALLER argObjKey, argFileInfo, argInputPath, argSourceETag, argRanges))
+    {
+        traceW(L"fault: PutObjectPartial argObjKey=%s", argObjKey.c_str());
+        return false;
+    }
+
+    // LbVE폜
+
+    const auto num = mQueryObject->qoDeleteCache(CONT_CALLER argObjKey);
+    traceW(L"cache delete num=%d, argObjKey=%s", num, argObjKey.c_str());
+
+    return true;
+}
+
+std::unique_ptr<IStreamUpload> CSDevice::beginStreamUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
+{
+    return mApiClient->BeginStreamUpload(CONT_CALLER argObjKey, argFileInfo, argInputPath);
+}
+
+bool CSDevice::completeStreamUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, CSELIB::IStreamUpload* argUpload, const FSP_FSCTL_FILE_INFO& argFileInfo)
+{
+    NEW_LOG_BLOCK();
+    APP_ASSERT(argUpload);
+
+    if (!argUpload->complete(CONT_CALLER argFileInfo))
+    {
+        errorW(L"fault: complete argObjKey=%s", argObjKey.c_str());
+        return false;
+    }
+
+    // LbVE폜
+
+    const auto num = mQueryObject->qoDeleteCache(CONT_CALLER argObjKey);
+    traceW(L"cache delete num=%d, argObjKey=%s", num, argObjKey.c_str());
+
+    return true;
+}
+
 bool CSDevice::copyObject(CALLER_ARG const CSELIB::ObjectKey& argSrcObjKey, const CSELIB::ObjectKey& argDstObjKey)
 {
     NEW_LOG_BLOCK();
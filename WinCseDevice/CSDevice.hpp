@@ -13,6 +13,10 @@ WINCSEDEVICE_API CSELIB::FILEIO_LENGTH_T writeFileFromStream(CALLER_ARG
     const std::filesystem::path& argOutputPath, CSELIB::FILEIO_OFFSET_T argOutputOffset,
     const std::istream* argInputStream, CSELIB::FILEIO_LENGTH_T argInputLength);
 
+WINCSEDEVICE_API CSELIB::FILEIO_LENGTH_T writeBufferFromStream(CALLER_ARG
+    PVOID argOutputBuffer,
+    const std::istream* argInputStream, CSELIB::FILEIO_LENGTH_T argInputLength);
+
 WINCSEDEVICE_API std::wstring getContentType(CALLER_ARG UINT64 argFileSize, PCWSTR argInputPath, const std::wstring& argKey);
 
 class CSDevice : public CSDeviceBase
@@ -30,8 +34,12 @@ public:
 	WINCSEDEVICE_API bool headObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey, CSELIB::DirEntryType* pDirEntry) override;
 	WINCSEDEVICE_API bool listObjects(CALLER_ARG const CSELIB::ObjectKey& argObjKey, CSELIB::DirEntryListType* pDirEntryList) override;
 	WINCSEDEVICE_API bool listDisplayObjects(CALLER_ARG const CSELIB::ObjectKey& argObjKey, CSELIB::DirEntryListType* pDirEntryList) override;
-	WINCSEDEVICE_API CSELIB::FILEIO_LENGTH_T getObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) override;
+	WINCSEDEVICE_API CSELIB::FILEIO_LENGTH_T getObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) override;
+	WINCSEDEVICE_API CSELIB::FILEIO_LENGTH_T getObjectAndWriteBuffer(CALLER_ARG const CSELIB::ObjectKey& argObjKey, PVOID argOutputBuffer, CSELIB::FILEIO_OFFSET_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) override;
 	WINCSEDEVICE_API bool putObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath) override;
+	WINCSEDEVICE_API bool putObjectPartial(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath, const std::wstring& argSourceETag, const std::list<CSELIB::UploadRange>& argRanges) override;
+	WINCSEDEVICE_API std::unique_ptr<CSELIB::IStreamUpload> beginStreamUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath) override;
+	WINCSEDEVICE_API bool completeStreamUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, CSELIB::IStreamUpload* argUpload, const FSP_FSCTL_FILE_INFO& argFileInfo) override;
 	WINCSEDEVICE_API bool copyObject(CALLER_ARG const CSELIB::ObjectKey& argSrcObjKey, const CSELIB::ObjectKey& argDstObjKey) override;
 	WINCSEDEVICE_API bool deleteObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey) override;
 	WINCSEDEVICE_API bool deleteObjects(CALLER_ARG const std::wstring& argBucket, const std::list<std::wstring>& argKeys) override;
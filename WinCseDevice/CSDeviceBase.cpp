@@ -175,6 +175,10 @@ NTSTATUS CSDeviceBase::OnSvcStart(PCWSTR argWorkDir, FSP_FILE_SYSTEM*)
         GetIniIntW(confPath,    mIniSection,    L"object_cache_expiry_min",          5,     1,          60),
         GetIniBoolW(confPath,   mIniSection,    L"strict_bucket_region",        false),
         GetIniBoolW(confPath,   mIniSection,    L"strict_file_timestamp",       false),
+        GetIniBoolW(confPath,   mIniSection,    L"transfer_auto_tune",           true),
+        GetIniIntW(confPath,    mIniSection,    L"transfer_max_parallel",            8,     1,          32),
+        GetIniIntW(confPath,    mIniSection,    L"transfer_max_size_mib",          100,     5,         100),
+        GetIniIntW(confPath,    mIniSection,    L"transfer_min_size_mib",            5,     5,         100),
         GetIniIntW(confPath,	mIniSection,	L"transfer_write_size_mib",			10,     5,          100)
     );
 
@@ -16,8 +16,11 @@ struct IApiClient
 	WINCSEDEVICE_API virtual bool DeleteObjects(CALLER_ARG const std::wstring& argBucket, const std::list<std::wstring>& argKeys);
 	virtual bool DeleteObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey) = 0;
 	virtual bool PutObject(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath) = 0;
+	WINCSEDEVICE_API virtual bool PutObjectPartial(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath, const std::wstring& argSourceETag, const std::list<CSELIB::UploadRange>& argRanges);
+	WINCSEDEVICE_API virtual std::unique_ptr<CSELIB::IStreamUpload> BeginStreamUpload(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath);
 	virtual bool CopyObject(CALLER_ARG const CSELIB::ObjectKey& argSrcObjKey, const CSELIB::ObjectKey& argDstObjKey) = 0;
-	virtual CSELIB::FILEIO_LENGTH_T GetObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength) = 0;
+	virtual CSELIB::FILEIO_LENGTH_T GetObjectAndWriteFile(CALLER_ARG const CSELIB::ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) = 0;
+	virtual CSELIB::FILEIO_LENGTH_T GetObjectAndWriteBuffer(CALLER_ARG const CSELIB::ObjectKey& argObjKey, PVOID argOutputBuffer, CSELIB::FILEIO_LENGTH_T argOffset, CSELIB::FILEIO_LENGTH_T argLength, const std::wstring& argETag) = 0;
 };
 
 }	// namespace CSEDVC
@@ -25,6 +25,10 @@ std::wstring RuntimeEnv::str() const
         KV_TO_WSTR(ObjectCacheExpiryMin),
         KV_BOOL(StrictBucketRegion),
         KV_BOOL(StrictFileTimestamp),
+        KV_BOOL(TransferAutoTune),
+        KV_TO_WSTR(TransferMaxParallel),
+        KV_TO_WSTR(TransferMaxSizeMib),
+        KV_TO_WSTR(TransferMinSizeMib),
         KV_TO_WSTR(TransferWriteSizeMib)
         }, L", ", true);
 }
@@ -20,6 +20,10 @@ struct RuntimeEnv final
 		int									argObjectCacheExpiryMin,
 		bool								argStrictBucketRegion,
 		bool								argStrictFileTimestamp,
+		bool								argTransferAutoTune,
+		int									argTransferMaxParallel,
+		int									argTransferMaxSizeMib,
+		int									argTransferMinSizeMib,
 		int									argTransferWriteSizeMib)
 		:
 		BucketCacheExpiryMin				(argBucketCacheExpiryMin),
@@ -34,6 +38,10 @@ struct RuntimeEnv final
 		ObjectCacheExpiryMin				(argObjectCacheExpiryMin),
 		StrictBucketRegion					(argStrictBucketRegion),
 		StrictFileTimestamp					(argStrictFileTimestamp),
+		TransferAutoTune					(argTransferAutoTune),
+		TransferMaxParallel					(argTransferMaxParallel),
+		TransferMaxSizeMib					(argTransferMaxSizeMib),
+		TransferMinSizeMib					(argTransferMinSizeMib),
 		TransferWriteSizeMib				(argTransferWriteSizeMib)
 	{
 	}
@@ -50,6 +58,10 @@ struct RuntimeEnv final
 	const int								ObjectCacheExpiryMin;
 	const bool								StrictBucketRegion;
 	const bool								StrictFileTimestamp;
+	const bool								TransferAutoTune;
+	const int								TransferMaxParallel;
+	const int								TransferMaxSizeMib;
+	const int								TransferMinSizeMib;
 	const int								TransferWriteSizeMib;
 
 	WINCSEDEVICE_API std::wstring str() const;
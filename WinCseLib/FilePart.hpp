@@ -9,6 +9,36 @@ class FilePart
 	EventHandle				mDone;
 	ResultT					mResult;
 
+	// ɌĂяo֐
+	// --> ҋ@Xbhg킸Ɋ󂯎邽
+
+	std::mutex							mCallbackGuard;
+	std::list<std::function<void()>>	mCallbacks;
+	bool								mCompleted = false;
+
+	void notify()
+	{
+		// ҋ@ĂXbhĊJOɁAo^ꂽ֐Ăяo
+		// --> ҋ@ (LZȂ) A֐ŎgĂ̂jȂ悤
+
+		std::list<std::function<void()>> callbacks;
+
+		{
+			std::lock_guard<std::mutex> lock_{ mCallbackGuard };
+
+			mCompleted = true;
+			callbacks.swap(mCallbacks);
+		}
+
+		for (const auto& callback: callbacks)
+		{
+			callback();
+		}
+
+		const auto b = ::SetEvent(mDone.handle());					// VOiԂɐݒ
+		APP_ASSERT(b);
+	}
+
 public:
 	const int				mPartNumber;
 	const FILEIO_OFFSET_T	mOffset;
@@ -36,15 +66,30 @@ public:
 	void setResult(const ResultT& argResult)
 	{
 		mResult = argResult;
-		const auto b = ::SetEvent(mDone.handle());					// VOiԂɐݒ
-		APP_ASSERT(b);
+		this->notify();
 	}
 
 	void setResult(ResultT&& argResult)
 	{
 		mResult = std::move(argResult);
-		const auto b = ::SetEvent(mDone.handle());					// VOiԂɐݒ
-		APP_ASSERT(b);
+		this->notify();
+	}
+
+	// ƂɌĂяo֐o^
+	// --> ɊĂƂ͓o^ false Ԃ
+
+	bool onComplete(std::function<void()>&& argCallback)
+	{
+		std::lock_guard<std::mutex> lock_{ mCallbackGuard };
+
+		if (mCompleted)
+		{
+			return false;
+		}
+
+		mCallbacks.push_back(std::move(argCallback));
+
+		return true;
 	}
 
 	ResultT getResult()
@@ -58,6 +103,13 @@ public:
 		return mResult;
 	}
 
+	bool isDone() const
+	{
+		// ҋ@ɊmF
+
+		return ::WaitForSingleObject(mDone.handle(), 0) == WAIT_OBJECT_0;
+	}
+
 	std::wstring str() const
 	{
 		std::wostringstream ss;
@@ -231,6 +231,33 @@ bool forEachDirs(const std::filesystem::path& argDir, const std::function<void(c
 	return true;
 }
 
+//
+// t@Cɕۑ郌R[h̑gݗĂƓǂݎ
+//
+
+void AppendBytesToBuffer(std::vector<BYTE>* pBuffer, const void* argData, size_t argBytes)
+{
+	const auto* p = static_cast<const BYTE*>(argData);
+
+	pBuffer->insert(pBuffer->end(), p, p + argBytes);
+}
+
+bool ReadStringFromBuffer(const BYTE* argPos, const BYTE* argEnd, UINT32 argLength, std::wstring* pString)
+{
+	// ̃f[^cĂȂΉĂ
+
+	const auto bytes = static_cast<size_t>(argLength) * sizeof(wchar_t);
+
+	if (static_cast<size_t>(argEnd - argPos) < bytes)
+	{
+		return false;
+	}
+
+	pString->assign(reinterpret_cast<const wchar_t*>(argPos), argLength);
+
+	return true;
+}
+
 } // CSELIB
 
 // EOF
\ No newline at end of file
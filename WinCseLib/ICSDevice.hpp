@@ -4,6 +4,36 @@
 
 namespace CSELIB {
 
+// putObjectPartial ŐVe\͈
+// --> mCopy  true ͈̔͂̓[g̕ύXO̓eRs[AȊO̓t@C瑗
+
+struct UploadRange
+{
+	FILEIO_OFFSET_T		mOffset;
+	FILEIO_LENGTH_T		mLength;
+	bool				mCopy;
+};
+
+// getObjectAndWriteFile(), getObjectAndWriteBuffer() Ŏw肵 ETag ƃ[g
+// vȂ (412) Ƃ̖߂l
+// --> ̑̃G[ -1
+
+constexpr FILEIO_LENGTH_T FILEIO_LENGTH_ETAG_MISMATCH = -2LL;
+
+// ݂ƕsĐi߂Abv[h
+// --> 擪珑܂ꂽ advance() ŒʒmAcomplete() Ŏc𑗂ĊB
+//     ɔjƂ̓Abv[h𒆒f
+// --> started() ̓p[g̑Mn߂Ă邩ǂ
+
+struct IStreamUpload
+{
+	virtual ~IStreamUpload() = default;
+
+	virtual bool started() const = 0;
+	virtual bool advance(CALLER_ARG FILEIO_LENGTH_T argWrittenLength) = 0;
+	virtual bool complete(CALLER_ARG const FSP_FSCTL_FILE_INFO& argFileInfo) = 0;
+};
+
 struct ICSDevice : public ICSService
 {
 	// ABSTRACT
@@ -14,7 +44,8 @@ struct ICSDevice : public ICSService
 	virtual bool listBuckets(CALLER_ARG DirEntryListType* pDirEntryList) = 0;
 	virtual bool headObject(CALLER_ARG const ObjectKey& argObjKey, DirEntryType* pDirEntry) = 0;
 	virtual bool listObjects(CALLER_ARG const ObjectKey& argObjKey, DirEntryListType* pDirEntryList) = 0;
-	virtual FILEIO_LENGTH_T getObjectAndWriteFile(CALLER_ARG const ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength) = 0;
+	virtual FILEIO_LENGTH_T getObjectAndWriteFile(CALLER_ARG const ObjectKey& argObjKey, const std::filesystem::path& argOutputPath, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag) = 0;
+	virtual FILEIO_LENGTH_T getObjectAndWriteBuffer(CALLER_ARG const ObjectKey& argObjKey, PVOID argOutputBuffer, FILEIO_OFFSET_T argOffset, FILEIO_LENGTH_T argLength, const std::wstring& argETag) = 0;
 	virtual bool putObject(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath) = 0;
 	virtual bool copyObject(CALLER_ARG const ObjectKey& argSrcObjKey, const ObjectKey& argDstObjKey) = 0;
 	virtual bool deleteObject(CALLER_ARG const ObjectKey& argObjKey) = 0;
@@ -22,6 +53,26 @@ struct ICSDevice : public ICSService
 
 	// DEFAULT IMPLEMENTS
 
+	virtual bool putObjectPartial(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath,
+		const std::wstring& argSourceETag, const std::list<UploadRange>& argRanges)
+	{
+		// ΉĂȂƂ́AĂяoőŜAbv[h
+
+		return false;
+	}
+
+	virtual std::unique_ptr<IStreamUpload> beginStreamUpload(CALLER_ARG const ObjectKey& argObjKey, const FSP_FSCTL_FILE_INFO& argFileInfo, PCWSTR argInputPath)
+	{
+		// ΉĂȂƂ́AN[YɑŜAbv[h
+
+		return nullptr;
+	}
+
+	virtual bool completeStreamUpload(CALLER_ARG const ObjectKey& argObjKey, IStreamUpload* argUpload, const FSP_FSCTL_FILE_INFO& argFileInfo)
+	{
+		return false;
+	}
+
 	virtual bool headObjectAsDirectory(CALLER_ARG const ObjectKey& argObjKey, DirEntryType* pDirEntry)
 	{
 		return this->headObject(CONT_CALLER argObjKey.toDir(), pDirEntry);
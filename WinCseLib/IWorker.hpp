@@ -20,6 +20,9 @@ struct IWorker : public ICSService
 
 struct IOnDemandTask : public ITask
 {
+	// Dx̒Ⴂ^XŃAʏ̃^XN҂ĂȂƂɌꂽ̃XbhŎs
+
+	virtual bool isLowPriority() const { return false; }
 };
 
 struct IScheduledTask : public ITask
@@ -0,0 +1,252 @@
+#include "WinCseLib.h"
+
+namespace CSELIB {
+
+TransferTuner::Slot::Slot(TransferTuner* argTuner)
+	:
+	mTuner(argTuner)
+{
+	APP_ASSERT(mTuner);
+
+	mTuner->acquire();
+
+	// g҂Ԃ͓]ԂɊ܂߂Ȃ
+
+	mStartMillis = GetCurrentUtcMillis();
+}
+
+TransferTuner::Slot::~Slot()
+{
+	const auto now = GetCurrentUtcMillis();
+
+	mTuner->release(mBytes, now > mStartMillis ? now - mStartMillis : 1ULL);
+}
+
+//
+// 牺̃\bh THREAD_SAFE }NɂCKv
+//
+
+#if defined(THREAD_SAFE)
+#error "THREAD_SAFFE(): already defined"
+#endif
+
+#define THREAD_SAFE() std::lock_guard<std::mutex> lock_{ mGuard }
+
+void TransferTuner::init(bool argEnabled, FILEIO_LENGTH_T argPartSize, FILEIO_LENGTH_T argMinPartSize, FILEIO_LENGTH_T argMaxPartSize, int argMaxInflight)
+{
+	THREAD_SAFE();
+
+	APP_ASSERT(argPartSize > 0);
+	APP_ASSERT(argMinPartSize > 0);
+	APP_ASSERT(argMaxInflight > 0);
+
+	mEnabled = argEnabled;
+
+	mMinPartSize = argMinPartSize;
+	mMaxPartSize = max(argMinPartSize, argMaxPartSize);
+	mMaxInflight = argMaxInflight;
+
+	// ȂƂ́Aݒl̂܂ܓsȂ
+
+	mPartSize = mEnabled ? min(max(argPartSize, mMinPartSize), mMaxPartSize) : argPartSize;
+	mInflightLimit = mEnabled ? min(max(mMaxInflight / 2, 1), mMaxInflight) : INT_MAX;
+
+	mPartBytesPerMs = 0LL;
+	mWindowParts = 0;
+	mWindowBytes = 0LL;
+	mBusyMillis = 0ULL;
+	mLastBytesPerSec = 0LL;
+	mDirection = 1;
+
+	mSumW = 0.0;
+	mSumX = 0.0;
+	mSumY = 0.0;
+	mSumXX = 0.0;
+	mSumXY = 0.0;
+}
+
+FILEIO_LENGTH_T TransferTuner::getPartSize() const
+{
+	THREAD_SAFE();
+
+	return mPartSize;
+}
+
+int TransferTuner::getInflightLimit() const
+{
+	THREAD_SAFE();
+
+	return mInflightLimit;
+}
+
+FILEIO_LENGTH_T TransferTuner::getBridgeBytes() const
+{
+	THREAD_SAFE();
+
+	// v񕪂̒x̊Ԃɓ]ł
+	// --> 苷ԊuȂAv𕪂Ԃ擾
+
+	const auto denom = mSumW * mSumXX - mSumX * mSumX;
+
+	if (mSumW < 4.0 || denom < 0.25 * mSumW * mSumW)
+	{
+		// 傫̈قȂp[g܂Ȃ (U 0.25 MiB^2 )AłȂ
+
+		return DEFAULT_BRIDGE_BYTES;
+	}
+
+	const auto slope = (mSumW * mSumXY - mSumX * mSumY) / denom;		// ms/MiB
+	const auto intercept = (mSumY - slope * mSumX) / mSumW;				// ms
+
+	if (slope <= 0.0 || intercept <= 0.0)
+	{
+		return DEFAULT_BRIDGE_BYTES;
+	}
+
+	const auto bridgeBytes = static_cast<FILEIO_LENGTH_T>(intercept / slope * static_cast<double>(FILESIZE_1MiBll));
+
+	return min(bridgeBytes, mMaxPartSize);
+}
+
+void TransferTuner::acquire()
+{
+	std::unique_lock<std::mutex> lock{ mGuard };
+
+	mCond.wait(lock, [this]{ return mInflight < mInflightLimit; });
+
+	if (mInflight == 0)
+	{
+		mBusySince = GetCurrentUtcMillis();
+	}
+
+	mInflight++;
+}
+
+void TransferTuner::release(FILEIO_LENGTH_T argBytes, UTC_MILLIS_T argElapsedMillis)
+{
+	{
+		THREAD_SAFE();
+
+		APP_ASSERT(mInflight > 0);
+
+		const auto now = GetCurrentUtcMillis();
+
+		mInflight--;
+
+		if (mInflight == 0)
+		{
+			mBusyMillis += now > mBusySince ? now - mBusySince : 0ULL;
+		}
+
+		if (argBytes > 0)
+		{
+			// xƑш̐
+
+			constexpr double DECAY = 0.95;
+
+			const auto x = static_cast<double>(argBytes) / static_cast<double>(FILESIZE_1MiBll);
+			const auto y = static_cast<double>(argElapsedMillis);
+
+			mSumW  = mSumW  * DECAY + 1.0;
+			mSumX  = mSumX  * DECAY + x;
+			mSumY  = mSumY  * DECAY + y;
+			mSumXX = mSumXX * DECAY + x * x;
+			mSumXY = mSumXY * DECAY + x * y;
+		}
+
+		if (mEnabled && argBytes > 0)
+		{
+			// ̐ڑł̓]x
+
+			const auto bytesPerMs = max(argBytes / static_cast<FILEIO_LENGTH_T>(argElapsedMillis), 1LL);
+
+			mPartBytesPerMs = mPartBytesPerMs == 0 ? bytesPerMs : (mPartBytesPerMs * 3 + bytesPerMs) / 4;
+
+			mWindowParts++;
+			mWindowBytes += argBytes;
+
+			if (mWindowParts >= WINDOW_PARTS)
+			{
+				this->adjust(now);
+			}
+		}
+	}
+
+	mCond.notify_all();
+}
+
+void TransferTuner::adjust(UTC_MILLIS_T argNow)
+{
+	// ]ĂԂ̓]
+
+	auto busyMillis = mBusyMillis;
+
+	if (mInflight > 0)
+	{
+		busyMillis += argNow > mBusySince ? argNow - mBusySince : 0ULL;
+		mBusySince = argNow;
+	}
+
+	const auto bytesPerSec = mWindowBytes * 1000LL / static_cast<FILEIO_LENGTH_T>(max(busyMillis, 1ULL));
+
+	// s
+	// --> 5% ȏǂȂΓɁA5% ȏ㈫Ȃ΋t̕ɓ
+
+	int step = 0;
+
+	if (mLastBytesPerSec == 0 || bytesPerSec > mLastBytesPerSec * 105 / 100)
+	{
+		step = mDirection;
+	}
+	else if (bytesPerSec < mLastBytesPerSec * 95 / 100)
+	{
+		mDirection = -mDirection;
+		step = mDirection;
+	}
+
+	mInflightLimit = min(max(mInflightLimit + step, 1), mMaxInflight);
+
+	if (mInflightLimit == 1 || mInflightLimit == mMaxInflight)
+	{
+		// [ɒ玟͖߂
+
+		mDirection = mInflightLimit == 1 ? 1 : -1;
+	}
+
+	// p[gTCY
+	// --> }ɕςȂ悤ɁAڕWƂ̒Ԃ MiB Pʂō킹
+
+	const auto targetPartSize = mPartBytesPerMs * static_cast<FILEIO_LENGTH_T>(TARGET_PART_MILLIS);
+	const auto partSize = (mPartSize + targetPartSize) / 2 / FILESIZE_1MiBll * FILESIZE_1MiBll;
+
+	mPartSize = min(max(partSize, mMinPartSize), mMaxPartSize);
+
+	mLastBytesPerSec = bytesPerSec;
+
+	mWindowParts = 0;
+	mWindowBytes = 0LL;
+	mBusyMillis = 0ULL;
+}
+
+std::wstring TransferTuner::str() const
+{
+	THREAD_SAFE();
+
+	std::wostringstream ss;
+
+	ss << L"mEnabled=" << BOOL_CSTRW(mEnabled);
+	ss << L" mPartSize=" << mPartSize;
+	ss << L" mInflightLimit=" << mInflightLimit;
+	ss << L" mInflight=" << mInflight;
+	ss << L" mPartBytesPerMs=" << mPartBytesPerMs;
+	ss << L" mLastBytesPerSec=" << mLastBytesPerSec;
+	ss << L" mSumW=" << mSumW;
+
+	return ss.str();
+}
+
+}	// namespace CSELIB
+
+#undef THREAD_SAFE
+
+// EOF
\ No newline at end of file
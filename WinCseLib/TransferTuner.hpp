@@ -0,0 +1,114 @@
+#pragma once
+
+#include <condition_variable>
+
+namespace CSELIB
+{
+
+//
+// ]̃p[gTCYƓs̎
+//
+// p[g̏vԂƓ]ʂL^A萔̃p[g邽тɎ̒l߂B
+//
+//	p[gTCY	... ̐ڑł̓]xA1 p[g TARGET_PART_MILLIS 
+//						I傫ɋ߂Â
+//	s		... ]Ԃ̓]ʂ 1 
+//
+// ܂Av񂠂̒xƑш𐄒肵Aꂽ͈͂xɎ擾邩̔fɎg
+//
+// ڑ (Wasabi, R2, B2 Ȃ) ɂčœKȒlقȂ̂ŁAݒ肳ꂽ͈͓Œ
+//
+
+class TransferTuner final
+{
+public:
+	static constexpr int WINDOW_PARTS = 8;
+	static constexpr UTC_MILLIS_T TARGET_PART_MILLIS = 2000ULL;
+	static constexpr FILEIO_LENGTH_T DEFAULT_BRIDGE_BYTES = FILESIZE_1MiBll;
+
+private:
+	bool mEnabled = false;
+
+	// ݒ肳ꂽ͈
+
+	FILEIO_LENGTH_T mMinPartSize = 0LL;
+	FILEIO_LENGTH_T mMaxPartSize = 0LL;
+	int mMaxInflight = 1;
+
+	// ݂̒l
+
+	FILEIO_LENGTH_T mPartSize = 0LL;
+	int mInflightLimit = INT_MAX;
+	int mInflight = 0;
+
+	// ̐ڑł̓]x (Byte/ms ̈ړ)
+
+	FILEIO_LENGTH_T mPartBytesPerMs = 0LL;
+
+	// v̋
+	// --> ]ĂȂԂ͊܂߂Ȃ
+
+	int mWindowParts = 0;
+	FILEIO_LENGTH_T mWindowBytes = 0LL;
+	UTC_MILLIS_T mBusyMillis = 0ULL;
+	UTC_MILLIS_T mBusySince = 0ULL;
+
+	// ŐԂ̓] (Byte/sec) Ɠs𓮂
+
+	FILEIO_LENGTH_T mLastBytesPerSec = 0LL;
+	int mDirection = 1;
+
+	// v = x + ] / ш ̐
+	// --> ŋ߂̃p[gقǏdȂ悤Ɍŏ@ (x: MiB, y: ms)
+
+	double mSumW = 0.0;
+	double mSumX = 0.0;
+	double mSumY = 0.0;
+	double mSumXX = 0.0;
+	double mSumXY = 0.0;
+
+	mutable std::mutex mGuard;
+	std::condition_variable mCond;
+
+	void acquire();
+	void release(FILEIO_LENGTH_T argBytes, UTC_MILLIS_T argElapsedMillis);
+	void adjust(UTC_MILLIS_T argNow);
+
+public:
+	//
+	// ]񕪂̘g
+	//
+	// ɓs̘g󂭂܂ő҂AjɏvԂL^B
+	// ]ɎsƂ (complete Ă΂ȂƂ) ͋L^Ȃ
+	//
+	class Slot final
+	{
+		TransferTuner* const mTuner;
+		UTC_MILLIS_T mStartMillis = 0ULL;
+		FILEIO_LENGTH_T mBytes = 0LL;
+
+	public:
+		WINCSELIB_API explicit Slot(TransferTuner* argTuner);
+		WINCSELIB_API ~Slot();
+
+		Slot(const Slot&) = delete;
+		Slot& operator=(const Slot&) = delete;
+
+		void complete(FILEIO_LENGTH_T argBytes)
+		{
+			mBytes = argBytes;
+		}
+	};
+
+	WINCSELIB_API void init(bool argEnabled, FILEIO_LENGTH_T argPartSize, FILEIO_LENGTH_T argMinPartSize, FILEIO_LENGTH_T argMaxPartSize, int argMaxInflight);
+
+	WINCSELIB_API FILEIO_LENGTH_T getPartSize() const;
+	WINCSELIB_API int getInflightLimit() const;
+	WINCSELIB_API FILEIO_LENGTH_T getBridgeBytes() const;
+
+	WINCSELIB_API std::wstring str() const;
+};
+
+}	// namespace CSELIB
+
+// EOF
\ No newline at end of file
@@ -108,6 +108,8 @@ WINCSELIB_API bool GetFileNameFromHandle(HANDLE hFile, std::filesystem::path* pP
 WINCSELIB_API bool mkdirIfNotExists(const std::filesystem::path& argDir);
 WINCSELIB_API bool forEachFiles(const std::filesystem::path& argDir, const std::function<void(const WIN32_FIND_DATA&, const std::filesystem::path&)>& callback);
 WINCSELIB_API bool forEachDirs(const std::filesystem::path& argDir, const std::function<void(const WIN32_FIND_DATA&, const std::filesystem::path&)>& callback);
+WINCSELIB_API void AppendBytesToBuffer(std::vector<BYTE>* pBuffer, const void* argData, size_t argBytes);
+WINCSELIB_API bool ReadStringFromBuffer(const BYTE* argPos, const BYTE* argEnd, UINT32 argLength, std::wstring* pString);
 
 WINCSELIB_API FILETIME_100NS_T UtcMillisToWinFileTime100ns(UTC_MILLIS_T argUtcMillis);
 WINCSELIB_API UTC_MILLIS_T WinFileTime100nsToUtcMillis(FILETIME_100NS_T ft100ns);
@@ -312,6 +314,7 @@ constexpr const wchar_t* const CONFIGFILE_FNAME = L"WinCse.conf";
 
 #include "Handle.hpp"
 #include "FilePart.hpp"
+#include "TransferTuner.hpp"
 
 // -----------------------------
 //
@@ -0,0 +1,139 @@
+#include "WinCseLib.h"
+#include "CacheExtents.hpp"
+#include <iostream>
+
+using namespace CSELIB;
+using namespace CSEDRV;
+
+static void printRanges(const std::list<CacheExtents::RangeType>& ranges)
+{
+	for (const auto& range: ranges)
+	{
+		std::wcout << L"  [" << range.first << L", " << range.first + range.second << L")" << std::endl;
+	}
+}
+
+static void t_CacheExtents_add_missing()
+{
+	CacheExtents extents;
+	extents.reset(100, L"etag-1");
+
+	extents.add(10, 10);		// [10, 20)
+	extents.add(30, 10);		// [30, 40)
+	extents.add(20, 5);			// [10, 25) ... אڂ̂͌
+	extents.add(35, 20);		// [30, 55) ... dȂ̂͌
+	extents.add(0, 0);			//  0 ͖
+
+	std::wcout << extents.str() << std::endl;
+
+	APP_ASSERT(extents.presentBytes() == 15 + 25);
+	APP_ASSERT(extents.contains(10, 15));
+	APP_ASSERT(extents.contains(30, 25));
+	APP_ASSERT(!extents.contains(10, 20));
+
+	const auto holes{ extents.missing(0, 100) };
+	printRanges(holes);
+
+	const std::list<CacheExtents::RangeType> expected{ { 0, 10 }, { 25, 5 }, { 55, 45 } };
+	APP_ASSERT(holes == expected);
+
+	// [g̃TCYȍ~͑ΏۊO
+
+	APP_ASSERT(extents.missing(55, 100) == (std::list<CacheExtents::RangeType>{ { 55, 45 } }));
+	APP_ASSERT(extents.missing(100, 10).empty());
+
+	// Ԋû͂܂Ƃ߂
+
+	const auto coalesced{ CacheExtents::coalesce(holes, 20) };
+	printRanges(coalesced);
+
+	APP_ASSERT(coalesced == (std::list<CacheExtents::RangeType>{ { 0, 30 }, { 55, 45 } }));
+}
+
+static void t_CacheExtents_truncate()
+{
+	CacheExtents extents;
+	extents.reset(100, L"etag-1");
+
+	extents.add(0, 20);
+	extents.add(40, 20);
+	extents.add(80, 20);
+
+	extents.truncate(50);
+
+	std::wcout << extents.str() << std::endl;
+
+	APP_ASSERT(extents.getRemoteSize() == 50);
+	APP_ASSERT(extents.presentBytes() == 20 + 10);
+	APP_ASSERT(extents.missing(0, 100) == (std::list<CacheExtents::RangeType>{ { 20, 20 } }));
+
+	// 擾ς͈̔͂c ETag ւ
+
+	extents.rebind(30, L"etag-2");
+
+	APP_ASSERT(extents.getETag() == L"etag-2");
+	APP_ASSERT(extents.getRemoteSize() == 30);
+	APP_ASSERT(extents.presentBytes() == 20);
+
+	extents.markModified();
+
+	APP_ASSERT(extents.getETag().empty());
+}
+
+static void t_CacheExtents_save_load()
+{
+	WCHAR tempDir[MAX_PATH];
+	::GetTempPathW(_countof(tempDir), tempDir);
+
+	const std::filesystem::path cacheFilePath{ std::filesystem::path{ tempDir } / L"t_CacheExtents.tmp" };
+
+	{
+		FileHandle file = ::CreateFileW(cacheFilePath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		APP_ASSERT(file.valid());
+	}
+
+	CacheExtents saved;
+	saved.reset(FILESIZE_1MiBll * 3, L"\"0123456789abcdef\"");
+	saved.add(0, FILESIZE_1MiBll);
+	saved.add(FILESIZE_1MiBll * 2, 100);
+
+	APP_ASSERT(saved.save(cacheFilePath));
+
+	CacheExtents loaded;
+	APP_ASSERT(loaded.load(cacheFilePath));
+
+	std::wcout << L"saved="  << saved.str()  << std::endl;
+	std::wcout << L"loaded=" << loaded.str() << std::endl;
+
+	APP_ASSERT(loaded.getETag() == saved.getETag());
+	APP_ASSERT(loaded.getRemoteSize() == saved.getRemoteSize());
+	APP_ASSERT(loaded.presentBytes() == saved.presentBytes());
+	APP_ASSERT(loaded.missing(0, saved.getRemoteSize()) == saved.missing(0, saved.getRemoteSize()));
+
+	// ㏑eǂ߂ (O̓ecȂ)
+
+	saved.reset(10, L"");
+	APP_ASSERT(saved.save(cacheFilePath));
+	APP_ASSERT(loaded.load(cacheFilePath));
+
+	APP_ASSERT(loaded.getETag().empty());
+	APP_ASSERT(loaded.getRemoteSize() == 10);
+	APP_ASSERT(loaded.presentBytes() == 0);
+
+	::DeleteFileW(cacheFilePath.c_str());
+
+	// ݂Ȃ͓̂ǂ߂Ȃ
+
+	APP_ASSERT(!loaded.load(cacheFilePath));
+}
+
+void t_WinCse_CacheExtents()
+{
+	t_CacheExtents_add_missing();
+	t_CacheExtents_truncate();
+	t_CacheExtents_save_load();
+
+	std::wcout << L"done." << std::endl;
+}
+
+// EOF
\ No newline at end of file
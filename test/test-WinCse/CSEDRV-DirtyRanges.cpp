@@ -0,0 +1,103 @@
+#include "WinCseLib.h"
+#include "DirtyRanges.hpp"
+#include <iostream>
+
+using namespace CSELIB;
+using namespace CSEDRV;
+
+using RangeList = std::list<CacheExtents::RangeType>;
+
+static void printRanges(const RangeList& ranges)
+{
+	for (const auto& range: ranges)
+	{
+		std::wcout << L"  [" << range.first << L", " << range.first + range.second << L")" << std::endl;
+	}
+}
+
+static void t_DirtyRanges_truncate()
+{
+	DirtyRanges dirtyRanges;
+	dirtyRanges.reset(100, L"etag-1");
+
+	dirtyRanges.add(10, 10);
+	dirtyRanges.add(50, 10);
+
+	std::wstring baseETag;
+	RangeList cleanRanges;
+
+	APP_ASSERT(dirtyRanges.getCleanRanges(100, &baseETag, &cleanRanges));
+	printRanges(cleanRanges);
+
+	APP_ASSERT(baseETag == L"etag-1");
+	APP_ASSERT(cleanRanges == (RangeList{ { 0, 10 }, { 20, 30 }, { 60, 40 } }));
+
+	// ؂l߂ʒuȍ~́AgĂύXO̓eł͂Ȃ
+
+	dirtyRanges.truncate(40);
+
+	APP_ASSERT(dirtyRanges.getCleanRanges(80, &baseETag, &cleanRanges));
+	printRanges(cleanRanges);
+
+	APP_ASSERT(cleanRanges == (RangeList{ { 0, 10 }, { 20, 20 } }));
+
+	// ŜuꂽL^Ȃ
+
+	dirtyRanges.clear();
+
+	APP_ASSERT(!dirtyRanges.getCleanRanges(80, &baseETag, &cleanRanges));
+	APP_ASSERT(!dirtyRanges.snapshot());
+}
+
+static void t_DirtyRanges_merge()
+{
+	// Abv[hOɍĂуN[YꂽƂ̌
+
+	DirtyRanges first;
+	first.reset(100, L"etag-1");
+	first.add(0, 10);
+	first.truncate(60);
+
+	DirtyRanges second;
+	second.reset(100, L"etag-1");
+	second.add(50, 20);
+
+	const auto prevRanges{ first.snapshot() };
+	auto newRanges{ second.snapshot() };
+
+	APP_ASSERT(prevRanges && newRanges);
+	APP_ASSERT(prevRanges->getETag() == newRanges->getETag());
+
+	newRanges->merge(*prevRanges);
+
+	std::wcout << newRanges->str() << std::endl;
+
+	// ύX͈͂͗킹AύXO̓eĉ͗ŎcĂ镔܂
+
+	APP_ASSERT(newRanges->getRemoteSize() == 60);
+	APP_ASSERT(newRanges->missing(0, 100) == (RangeList{ { 10, 40 } }));
+
+	// Abv[hɕ
+
+	DirtyRanges restored;
+	restored.restore(*newRanges);
+
+	std::wstring baseETag;
+	RangeList cleanRanges;
+
+	APP_ASSERT(restored.getCleanRanges(100, &baseETag, &cleanRanges));
+	printRanges(cleanRanges);
+
+	APP_ASSERT(baseETag == L"etag-1");
+	APP_ASSERT(cleanRanges == (RangeList{ { 10, 40 } }));
+}
+
+void t_WinCse_DirtyRanges()
+{
+	t_DirtyRanges_truncate();
+	t_DirtyRanges_merge();
+
+	std::wcout << L"done." << std::endl;
+}
+
+// EOF
\ No newline at end of file
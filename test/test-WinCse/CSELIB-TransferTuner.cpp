@@ -0,0 +1,80 @@
+#include "WinCseLib.h"
+#include "TransferTuner.hpp"
+#include <iostream>
+
+using namespace CSELIB;
+
+static void transfer(TransferTuner* tuner, int count, FILEIO_LENGTH_T bytes, FILEIO_LENGTH_T minPartSize, FILEIO_LENGTH_T maxPartSize, int maxInflight)
+{
+	for (int i=0; i<count; i++)
+	{
+		{
+			TransferTuner::Slot slot{ tuner };
+
+			slot.complete(bytes);
+		}
+
+		const auto partSize = tuner->getPartSize();
+		const auto inflightLimit = tuner->getInflightLimit();
+
+		APP_ASSERT(minPartSize <= partSize && partSize <= maxPartSize);
+		APP_ASSERT(1 <= inflightLimit && inflightLimit <= maxInflight);
+	}
+
+	std::wcout << tuner->str() << std::endl;
+}
+
+void t_WinCseLib_TransferTuner()
+{
+	const auto minPartSize = FILESIZE_1MiBll * 4;
+	const auto maxPartSize = FILESIZE_1MiBll * 16;
+	const int maxInflight = 4;
+
+	TransferTuner tuner;
+
+	// ݒl͔͈͓Ɏ߂
+
+	tuner.init(true, FILESIZE_1MiBll * 8, minPartSize, maxPartSize, maxInflight);
+	APP_ASSERT(tuner.getPartSize() == FILESIZE_1MiBll * 8);
+	APP_ASSERT(tuner.getInflightLimit() == maxInflight / 2);
+
+	tuner.init(true, FILESIZE_1MiBll * 64, minPartSize, maxPartSize, maxInflight);
+	APP_ASSERT(tuner.getPartSize() == maxPartSize);
+
+	tuner.init(true, FILESIZE_1MiBll, minPartSize, maxPartSize, maxInflight);
+	APP_ASSERT(tuner.getPartSize() == minPartSize);
+
+	// ȂƂ͐ݒl̂܂
+
+	tuner.init(false, FILESIZE_1MiBll * 64, minPartSize, maxPartSize, maxInflight);
+	APP_ASSERT(tuner.getPartSize() == FILESIZE_1MiBll * 64);
+	APP_ASSERT(tuner.getInflightLimit() == INT_MAX);
+
+	transfer(&tuner, TransferTuner::WINDOW_PARTS * 4, FILESIZE_1GiBll, FILESIZE_1MiBll * 64, FILESIZE_1MiBll * 64, INT_MAX);
+
+	// ]ł͏܂ő傫Ȃ
+
+	tuner.init(true, FILESIZE_1MiBll * 8, minPartSize, maxPartSize, maxInflight);
+	transfer(&tuner, TransferTuner::WINDOW_PARTS * 4, FILESIZE_1GiBll, minPartSize, maxPartSize, maxInflight);
+
+	APP_ASSERT(tuner.getPartSize() == maxPartSize);
+
+	// x]ł͉܂ŏȂ
+	// --> ]x͈ړςȂ̂ŁAƂ̒l܂ő
+
+	transfer(&tuner, TransferTuner::WINDOW_PARTS * 16, 1LL, minPartSize, maxPartSize, maxInflight);
+
+	APP_ASSERT(tuner.getPartSize() == minPartSize);
+
+	// s] (complete Ă΂Ȃ) ͋L^Ȃ
+
+	{
+		TransferTuner::Slot slot{ &tuner };
+	}
+
+	APP_ASSERT(tuner.getPartSize() == minPartSize);
+
+	std::wcout << L"done." << std::endl;
+}
+
+// EOF
\ No newline at end of file
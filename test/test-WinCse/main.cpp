@@ -42,6 +42,15 @@ void t_WinCseLib_Protect();
 // [WinCseLib/CSELIB-Time.cpp]
 void t_WinCseLib_Time();
 
+// [WinCseLib/CSELIB-TransferTuner.cpp]
+void t_WinCseLib_TransferTuner();
+
+// [WinCse/CSEDRV-CacheExtents.cpp]
+void t_WinCse_CacheExtents();
+
+// [WinCse/CSEDRV-DirtyRanges.cpp]
+void t_WinCse_DirtyRanges();
+
 // [WinCseLib-aws-s3/CSEAS3-Find.cpp]
 void t_WinCseLib_aws_s3_Find();
 
@@ -106,6 +115,21 @@ int wmain(int, wchar_t**)
     t_WinCseLib_Time();
 #endif
 
+#if 0
+    /* [WinCseLib/CSELIB-TransferTuner.cpp] */
+    t_WinCseLib_TransferTuner();
+#endif
+
+#if 0
+    /* [WinCse/CSEDRV-CacheExtents.cpp] */
+    t_WinCse_CacheExtents();
+#endif
+
+#if 0
+    /* [WinCse/CSEDRV-DirtyRanges.cpp] */
+    t_WinCse_DirtyRanges();
+#endif
+
 #if 0
     /* [WinCseLib-aws-s3/CSEAS3-Find.cpp] */
     t_WinCseLib_aws_s3_Find();